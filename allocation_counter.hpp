@@ -0,0 +1,155 @@
+#ifndef _allocation_counter_hpp_
+#define _allocation_counter_hpp_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and operator delete with versions that
+// count every allocation the program makes, so tests and benchmarks can check
+// how many allocations an operation costs.
+//
+// The aligned forms are replaced too, since std::pmr::new_delete_resource(),
+// the default memory resource, allocates through them, and so are the
+// std::nothrow and array forms. std::get_temporary_buffer(), which
+// std::inplace_merge() and std::stable_sort() use, allocates with
+// std::nothrow and frees with the plain operator delete; left to the library,
+// and to sanitizers that intercept every form, that pairs one allocator's
+// memory with another's delete, and those allocations go uncounted.
+//
+// The replacements are ordinary (non-inline) function definitions, so include
+// this header from exactly one translation unit of a program.
+//
+// GCC pairs the std::free() in each replacement operator delete with the
+// operator new of the code it is inlined into, and warns that the two do not
+// match. They do, since each replacement operator new calls std::malloc().
+
+namespace allocation_counter {
+  // The number of allocations made since the program started.
+  inline std::atomic<std::size_t> allocations{0};
+
+  // The number of bytes requested by those allocations.
+  inline std::atomic<std::size_t> bytes_allocated{0};
+
+  // Returns how many allocations `operation` makes.
+  template <typename Operation>
+  std::size_t count(Operation&& operation) {
+    const std::size_t before = allocations.load();
+    operation();
+    return allocations.load() - before;
+  }
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+  ++allocation_counter::allocations;
+  allocation_counter::bytes_allocated += size;
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  ++allocation_counter::allocations;
+  allocation_counter::bytes_allocated += size;
+
+  // std::aligned_alloc() wants a size that is a multiple of the alignment.
+  const std::size_t align = static_cast<std::size_t>(alignment);
+  const std::size_t rounded = (size == 0 ? align : (size + align - 1) / align * align);
+  if (void* memory = std::aligned_alloc(align, rounded)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return ::operator new(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  try {
+    return ::operator new(size, alignment);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+void* operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& nothrow) noexcept {
+  return ::operator new(size, nothrow);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t& nothrow) noexcept {
+  return ::operator new(size, alignment, nothrow);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#  pragma GCC diagnostic pop
+#endif
+
+#endif
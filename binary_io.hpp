@@ -0,0 +1,61 @@
+#ifndef _binary_io_hpp_
+#define _binary_io_hpp_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Helpers shared by the binary file formats: fixed-width little-endian
+// integers, so files read the same on every machine, and the FNV-1a hash the
+// formats use as a checksum.
+namespace binary_io {
+  // Appends `value` to `bytes` as four little-endian bytes.
+  inline void put_u32(std::string& bytes, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+      bytes += static_cast<char>((value >> shift) & 0xFF);
+    }
+  }
+
+  // Appends `value` to `bytes` as eight little-endian bytes.
+  inline void put_u64(std::string& bytes, std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+      bytes += static_cast<char>((value >> shift) & 0xFF);
+    }
+  }
+
+  // Overwrites the eight bytes at `offset` with `value`, little-endian.
+  inline void patch_u64(std::string& bytes, std::size_t offset, std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+      bytes[offset++] = static_cast<char>((value >> shift) & 0xFF);
+    }
+  }
+
+  // Returns the little-endian integer in the four bytes at `bytes`.
+  inline std::uint32_t get_u32(const char* bytes) {
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+      value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+  }
+
+  // Returns the little-endian integer in the eight bytes at `bytes`.
+  inline std::uint64_t get_u64(const char* bytes) {
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+      value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+  }
+
+  // Returns the 64-bit FNV-1a hash of `bytes`.
+  inline std::uint64_t fnv1a(std::string_view bytes) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : bytes) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash;
+  }
+}
+
+#endif
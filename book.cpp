@@ -1,25 +1,70 @@
 #include "book.hpp"
 
+#include <charconv>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
+#include "string_pool.hpp"
+
+namespace {
+  // The book every moved-from book is reset to. Built before main(), so no
+  // move allocates to build it.
+  const Book empty_book;
+}
+
 //
 // Constructors, Assignments, and Destructor
 //
 
-Book::Book(const std::string& title,
-           const std::string& author,
-           const std::string& isbn, 
-           double price) : title_(title), author_(author), isbn_(isbn), price_(price) {}
+Book::Book(std::string_view title,
+           std::string_view author,
+           std::string_view isbn,
+           double price)
+    : isbn_(isbn),
+      title_(&StringPool::shared().intern(title)),
+      author_(&StringPool::shared().intern(author)),
+      price_(price) {
+  update_keys();
+}
 
 Book::Book(const Book& other) = default;
 
 Book& Book::operator=(const Book& rhs) = default;
 
+// The move operations let std::move and std::vector reallocation steal the
+// strings instead of copying them. Taking the ISBN empties the source's, so
+// its other attributes and cached keys are reset to match.
+Book::Book(Book&& other) noexcept
+    : isbn_(std::move(other.isbn_)),
+      title_(other.title_),
+      author_(other.author_),
+      price_(other.price_),
+      hash_(other.hash_),
+      isbn_key_(other.isbn_key_) {
+  other.reset();
+}
+
+Book& Book::operator=(Book&& rhs) noexcept {
+  if (this != &rhs) {
+    isbn_ = std::move(rhs.isbn_);
+    title_ = rhs.title_;
+    author_ = rhs.author_;
+    price_ = rhs.price_;
+    hash_ = rhs.hash_;
+    isbn_key_ = rhs.isbn_key_;
+    rhs.reset();
+  }
+  return *this;
+}
+
 // Destructor
 Book::~Book() noexcept = default;
 
@@ -34,12 +79,12 @@ const std::string& Book::isbn() const {
 
 const std::string& Book::title() const {
   // returns a const reference to Book's title
-  return title_;
+  return *title_;
 }
 
 const std::string& Book::author() const {
   // returns a const reference to Book's author
-  return author_;
+  return *author_;
 }
 
 double Book::price() const {
@@ -47,42 +92,70 @@ double Book::price() const {
   return price_;
 }
 
-std::string Book::isbn() {
-  // returns the isbn of a Book object 
-  return isbn_;
+std::size_t Book::hash() const noexcept {
+  // returns the hash cached by update_keys()
+  return hash_;
 }
 
-std::string Book::title() {
-  // returns the title of a Book object
-  return title_;
+std::uint64_t Book::isbn_key() const noexcept {
+  // returns the key cached by update_keys()
+  return isbn_key_;
 }
 
-std::string Book::author() {
-  // returns the author of a Book object
-  return author_;
+std::string& Book::write_to(std::string& buffer) const {
+  // Mirrors operator<< below: std::quoted wraps each string in double quotes
+  // and escapes embedded quotes and backslashes with a backslash, and a
+  // stream with default formatting writes a double as printf's "%.6g" does,
+  // which std::to_chars reproduces without consulting the locale.
+  const auto append_quoted = [&buffer](const std::string& text) {
+    buffer += '"';
+    for (char c : text) {
+      if (c == '"' || c == '\\') {
+        buffer += '\\';
+      }
+      buffer += c;
+    }
+    buffer += '"';
+  };
+
+  append_quoted(isbn_);
+  buffer += ',';
+  append_quoted(*title_);
+  buffer += ',';
+  append_quoted(*author_);
+  buffer += ',';
+
+  char price[32];
+  const auto result = std::to_chars(price, price + sizeof(price), price_, std::chars_format::general, 6);
+  buffer.append(price, result.ptr);
+  buffer += '\n';
+  return buffer;
 }
 
 //
 // Modifiers
 //
 
-Book& Book::isbn(const std::string& new_isbn) {
-  // sets the isbn of this object to new_isbn
-  isbn_ = new_isbn;
+Book& Book::isbn(std::string_view new_isbn) {
+  // sets the isbn of this object to new_isbn, reusing its buffer
+  isbn_.assign(new_isbn);
+  update_keys();
   // returns the current instance of the Book class
   return *this;
 }
 
-Book& Book::title(const std::string& new_title) {
-  // sets the title of this object to new_title
-  title_ = new_title;
+Book& Book::title(std::string_view new_title) {
+  // sets the title of this object to new_title, sharing the pooled copy
+  title_ = &StringPool::shared().intern(new_title);
+  update_keys();
   // returns the current instance of Book class
   return *this;
 }
 
-Book& Book::author(const std::string& new_author) {
-  // sets the author of this object to new_author
-  author_ = new_author;
+Book& Book::author(std::string_view new_author) {
+  // sets the author of this object to new_author, sharing the pooled copy
+  author_ = &StringPool::shared().intern(new_author);
+  update_keys();
   // returns the current instance of Book
   return *this;
 }
@@ -90,6 +163,7 @@ Book& Book::author(const std::string& new_author) {
 Book& Book::price(double new_price) {
   // sets the price of this object to new_price
   price_ = new_price;
+  update_keys();
   // returns the current instance of Book
   return *this;
 }
@@ -103,8 +177,13 @@ bool Book::operator==(const Book& rhs) const noexcept {
   //
   // This can be done in any order, so put the quickest and the most likely
   // to be different first.
+  //
+  // The cached hashes of equal books are equal, so a hash mismatch rejects
+  // most unequal books with one integer comparison. Titles and authors are
+  // interned, so equal text means the same pooled string and comparing the
+  // handles is enough.
 
-  return isbn_ == rhs.isbn_ && title_ == rhs.title_ && author_ == rhs.author_ && price_ == rhs.price_;
+  return hash_ == rhs.hash_ && isbn_key_ == rhs.isbn_key_ && isbn_ == rhs.isbn_ && title_ == rhs.title_ && author_ == rhs.author_ && price_ == rhs.price_;
 }
 
 bool Book::operator!=(const Book& rhs) const noexcept {
@@ -117,17 +196,24 @@ bool Book::operator!=(const Book& rhs) const noexcept {
 bool Book::operator<(const Book& rhs) const noexcept {
   // Books are ordered (sorted) by ISBN, author, title, then price.
 
+  // The ISBN keys order books the same way the ISBNs do whenever the keys
+  // differ, so most comparisons end here without touching the strings.
+  if (isbn_key_ != rhs.isbn_key_) {
+    return isbn_key_ < rhs.isbn_key_;
+  }
+
   // if isbn_ is not equal to rhs.isbn_, then return if isbn_ is less than rhs.isbn_
   if (isbn_ != rhs.isbn_) {
     return isbn_ < rhs.isbn_;
   }
   // returns if author_ is less than rhs.author_, if they are not equal
+  // (Distinct handles always point to different text.)
   if (author_ != rhs.author_) {
-    return author_ < rhs.author_;
+    return *author_ < *rhs.author_;
   }
   // returns if title_ is less than rhs.title_, if they are not equal
   if (title_ != rhs.title_) {
-    return title_ < rhs.title_;
+    return *title_ < *rhs.title_;
   }
 
   // returns if price_ is less than rhs.price_, if they are not equal
@@ -162,6 +248,48 @@ bool Book::operator>=(const Book& rhs) const noexcept {
     return rhs <= *this;
 }
 
+//
+// Hashing
+//
+
+void Book::update_keys() noexcept {
+  // Mix the attribute hashes the same way boost::hash_combine does, so books
+  // differing in only one attribute still land in different buckets.
+  // Interned strings are equal exactly when their addresses are, so the
+  // addresses can be hashed instead of the text.
+  std::size_t seed = std::hash<std::string>{}(isbn_);
+  const auto combine = [&seed](std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+  };
+  combine(std::hash<const std::string*>{}(title_));
+  combine(std::hash<const std::string*>{}(author_));
+  combine(std::hash<double>{}(price_));
+  hash_ = seed;
+
+  // Pack the leading characters most significant first, as unsigned values,
+  // matching the order std::string::compare() uses.
+  isbn_key_ = 0;
+  for (std::size_t i = 0; i < sizeof(isbn_key_); ++i) {
+    const unsigned char c = i < isbn_.size() ? static_cast<unsigned char>(isbn_[i]) : 0;
+    isbn_key_ = (isbn_key_ << 8) | c;
+  }
+}
+
+void Book::reset() noexcept {
+  // The empty book's keys are copied rather than recomputed, so a move costs
+  // no hashing.
+  isbn_.clear();
+  title_ = empty_book.title_;
+  author_ = empty_book.author_;
+  price_ = empty_book.price_;
+  hash_ = empty_book.hash_;
+  isbn_key_ = empty_book.isbn_key_;
+}
+
+std::size_t std::hash<Book>::operator()(const Book& book) const noexcept {
+  return book.hash();
+}
+
 //
 // Insertion and Extraction Operators
 //
@@ -189,13 +317,23 @@ std::istream & operator>>(std::istream& stream, Book& book) {
   // This makes sure that book is not mutated if stream 
   // throws an exception 
   Book temp_book;
+  std::string title, author;
   stream >> std::quoted(temp_book.isbn_);
   stream.ignore(1);
-  stream >> std::quoted(temp_book.title_);
+  stream >> std::quoted(title);
   stream.ignore(1);
-  stream >> std::quoted(temp_book.author_);
+  stream >> std::quoted(author);
   stream.ignore(1);
   stream >> temp_book.price_;
+
+  // A record that could not be read leaves book as it was, and adds nothing
+  // to the pool.
+  if (!stream) {
+    return stream;
+  }
+  temp_book.title_ = &StringPool::shared().intern(title);
+  temp_book.author_ = &StringPool::shared().intern(author);
+  temp_book.update_keys();
   //
   // The temporary book object is moved into book since 
   // the stream was read from successfully 
@@ -209,13 +347,16 @@ std::ostream& operator<<(std::ostream& stream, const Book& book) {
   // This function should be symmetrical with operator>> above.
   // Insert isbn (quoted), a comma, title (quoted), a comma, 
   // author (quoted), a comma, and price into stream. 
+  //
+  // The record ends with '\n' rather than std::endl, so writing a whole
+  // book list does not flush the stream once per book.
   stream << std::quoted(book.isbn_)
       << ","
-      << std::quoted(book.title_)
+      << std::quoted(*book.title_)
       << ","
-      << std::quoted(book.author_) 
+      << std::quoted(*book.author_) 
       << ","
       << book.price_
-      << std::endl;
+      << '\n';
   return stream;
 }
\ No newline at end of file
@@ -1,11 +1,19 @@
 #ifndef _book_hpp_
 #define _book_hpp_
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <string_view>
 
 // The Book class encapsulates basic information about a book that could be sold
 // by a retailer such as Amazon or Barnes & Noble.
+//
+// Titles and authors repeat across a catalog, so a book keeps only a handle
+// to the copy held by StringPool::shared(). The ISBN stays inline: at 10 or 13
+// characters it fits std::string's small string buffer without allocating.
 class Book {
   //
   // Insertion and Extraction Operators
@@ -19,37 +27,58 @@ class Book {
   // Constructors, Assignments, and Destructor
   //
 
-  Book(const std::string& title = {},
-       const std::string& author = {},
-       const std::string& isbn = {},
+  // The attributes are taken as views, so literals and views build a book
+  // without temporary strings. Only an ISBN too long for the small string
+  // buffer allocates; titles and authors already pooled allocate nothing.
+  Book(std::string_view title = {},
+       std::string_view author = {},
+       std::string_view isbn = {},
        const double price = 0.0);
 
   Book& operator=(const Book& rhs);
 
+  // A moved-from book is left equal to Book(), keys included.
+  Book& operator=(Book&& rhs) noexcept;
+
   Book(const Book& other);
 
+  Book(Book&& other) noexcept;
+
   ~Book() noexcept;
 
   //
   // Accessors
   //
 
+  // The accessors return references to the book's own strings and never
+  // allocate.
   const std::string& isbn () const;
   const std::string& title () const;
   const std::string& author() const;
   double price () const;
 
-  std::string isbn();
-  std::string title();
-  std::string author();
+  // Returns the hash of all four attributes, computed when the book was built
+  // or last modified.
+  std::size_t hash() const noexcept;
+
+  // Returns the first eight characters of the ISBN packed into an integer,
+  // which orders books as their ISBNs do whenever two keys differ.
+  std::uint64_t isbn_key() const noexcept;
+
+  // Appends the book to `buffer` in the text format operator<< writes to a
+  // stream with default formatting, byte for byte, and returns `buffer`.
+  std::string& write_to(std::string& buffer) const;
 
   //
   // Modifiers
   //
 
-  Book& isbn (const std::string& new_isbn);
-  Book& title (const std::string& new_title);
-  Book& author(const std::string& new_author);
+  // The ISBN is assigned into the book's existing buffer, and titles and
+  // authors already pooled are shared, so none of these allocate unless the
+  // text is new or longer than the book held before.
+  Book& isbn (std::string_view new_isbn);
+  Book& title (std::string_view new_title);
+  Book& author(std::string_view new_author);
   Book& price (double new_price);
 
   //
@@ -64,26 +93,51 @@ class Book {
   bool operator>=(const Book& rhs) const noexcept;
 
  private:
+  // Recomputes hash_ and isbn_key_ from the attributes. Every modifier calls
+  // this after changing an attribute.
+  void update_keys() noexcept;
+
+  // Makes this book equal to Book(), as a move leaves the book it moves from.
+  void reset() noexcept;
+
   // The 10 or 13 character international standard book number uniquely
   // identifying this book.
   //
   // Examples: "9790619213090" or "979010181X".
   std::string isbn_;
 
-  // The name of the book.
+  // The name of the book, interned in StringPool::shared().
   //
   // Example: "An Introduction to Programming with C++".
-  std::string title_;
+  const std::string* title_;
 
-  // The book's author.
+  // The book's author, interned in StringPool::shared().
   //
   // Example: "Diane Zak".
-  std::string author_;
+  const std::string* author_;
 
   // The cost of the book in US dollars.
   //
   // Example: 31.99.
   double price_ = 0.0;
+
+  // The hash of all four attributes, so unequal books can usually be told
+  // apart with a single integer comparison.
+  std::size_t hash_ = 0;
+
+  // The first eight characters of isbn_, packed big-endian and zero padded,
+  // so comparing keys orders books the same way comparing their ISBNs does
+  // whenever the keys differ.
+  std::uint64_t isbn_key_ = 0;
 };
 
+// Hashes all four attributes, so books that compare equal hash equally. The
+// hash is cached in the book, so this costs nothing.
+namespace std {
+  template <>
+  struct hash<Book> {
+    std::size_t operator()(const Book& book) const noexcept;
+  };
+}
+
 #endif
\ No newline at end of file
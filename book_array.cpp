@@ -0,0 +1,209 @@
+#include "book_array.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "book.hpp"
+
+namespace {
+  // The number of slots allocated the first time a book is inserted.
+  constexpr std::size_t initial_allocation = 4;
+}
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookArray::BookArray(std::size_t capacity, std::pmr::memory_resource* resource) noexcept
+    : allocator_(resource), capacity_(capacity) {}
+
+BookArray::BookArray(const BookArray& other)
+    : BookArray(other, std::pmr::get_default_resource()) {}
+
+BookArray::BookArray(const BookArray& other, std::pmr::memory_resource* resource)
+    : allocator_(resource), capacity_(other.capacity_) {
+  if (other.size_ == 0) {
+    return;
+  }
+  books_ = allocator_.allocate(other.size_);
+  allocated_ = other.size_;
+  try {
+    std::uninitialized_copy(other.begin(), other.end(), books_);
+  } catch (...) {
+    allocator_.deallocate(books_, allocated_);
+    throw;
+  }
+  size_ = other.size_;
+}
+
+BookArray::BookArray(BookArray&& other) noexcept
+    : allocator_(other.allocator_),
+      books_(std::exchange(other.books_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      allocated_(std::exchange(other.allocated_, 0)),
+      capacity_(other.capacity_) {}
+
+BookArray& BookArray::operator=(const BookArray& rhs) {
+  if (this != &rhs) {
+    BookArray copy(rhs, allocator_.resource());
+    swap(copy);
+  }
+  return *this;
+}
+
+BookArray& BookArray::operator=(BookArray&& rhs) {
+  if (this == &rhs) {
+    return *this;
+  }
+
+  if (allocator_ == rhs.allocator_) {
+    BookArray moved(std::move(rhs));
+    swap(moved);
+  } else {
+    // Storage from another resource cannot be adopted, so the books move into
+    // storage from this one.
+    BookArray moved(rhs.capacity_, allocator_.resource());
+    if (rhs.size_ != 0) {
+      moved.reallocate(rhs.size_);
+      std::uninitialized_move(rhs.begin(), rhs.end(), moved.books_);
+      moved.size_ = rhs.size_;
+    }
+    rhs.clear();
+    swap(moved);
+  }
+  return *this;
+}
+
+BookArray::~BookArray() noexcept {
+  clear();
+  if (books_ != nullptr) {
+    allocator_.deallocate(books_, allocated_);
+  }
+}
+
+//
+// Queries
+//
+
+std::size_t BookArray::size() const noexcept {
+  return size_;
+}
+
+std::size_t BookArray::capacity() const noexcept {
+  return capacity_;
+}
+
+bool BookArray::full() const noexcept {
+  return size_ >= capacity_;
+}
+
+BookArray::allocator_type BookArray::get_allocator() const noexcept {
+  return allocator_;
+}
+
+Book& BookArray::operator[](std::size_t offset) noexcept {
+  return books_[offset];
+}
+
+const Book& BookArray::operator[](std::size_t offset) const noexcept {
+  return books_[offset];
+}
+
+BookArray::iterator BookArray::begin() noexcept {
+  return books_;
+}
+
+BookArray::iterator BookArray::end() noexcept {
+  return books_ + size_;
+}
+
+BookArray::const_iterator BookArray::begin() const noexcept {
+  return books_;
+}
+
+BookArray::const_iterator BookArray::end() const noexcept {
+  return books_ + size_;
+}
+
+BookArray::const_iterator BookArray::cbegin() const noexcept {
+  return books_;
+}
+
+BookArray::const_iterator BookArray::cend() const noexcept {
+  return books_ + size_;
+}
+
+//
+// Mutators
+//
+
+void BookArray::insert(std::size_t offset, const Book& book) {
+  // Copy first, so a book already in this array survives the shift.
+  insert(offset, Book(book));
+}
+
+void BookArray::insert(std::size_t offset, Book&& book) {
+  if (size_ == allocated_) {
+    grow();
+  }
+
+  if (offset == size_) {
+    ::new (static_cast<void*>(books_ + size_)) Book(std::move(book));
+  } else {
+    // The last book moves into the first uninitialized slot, the rest shift
+    // right by one within the initialized slots, and the new book takes the
+    // slot left at offset.
+    ::new (static_cast<void*>(books_ + size_)) Book(std::move(books_[size_ - 1]));
+    std::move_backward(books_ + offset, books_ + size_ - 1, books_ + size_);
+    books_[offset] = std::move(book);
+  }
+  ++size_;
+}
+
+void BookArray::erase(std::size_t offset) {
+  std::move(books_ + offset + 1, books_ + size_, books_ + offset);
+  --size_;
+  std::destroy_at(books_ + size_);
+}
+
+void BookArray::clear() noexcept {
+  std::destroy(books_, books_ + size_);
+  size_ = 0;
+}
+
+void BookArray::swap(BookArray& rhs) noexcept {
+  std::swap(books_, rhs.books_);
+  std::swap(size_, rhs.size_);
+  std::swap(allocated_, rhs.allocated_);
+  std::swap(capacity_, rhs.capacity_);
+}
+
+void BookArray::reserve(std::size_t count) {
+  count = std::min(count, capacity_);
+  if (count > allocated_) {
+    reallocate(count);
+  }
+}
+
+void BookArray::grow() {
+  const std::size_t wanted = allocated_ == 0 ? initial_allocation : allocated_ * 2;
+  reallocate(std::min(std::max(wanted, allocated_ + 1), capacity_));
+}
+
+void BookArray::reallocate(std::size_t new_allocated) {
+  Book* const new_books = allocator_.allocate(new_allocated);
+
+  // Book's move constructor is noexcept, so relocating cannot fail halfway.
+  std::uninitialized_move(books_, books_ + size_, new_books);
+  std::destroy(books_, books_ + size_);
+  if (books_ != nullptr) {
+    allocator_.deallocate(books_, allocated_);
+  }
+
+  books_ = new_books;
+  allocated_ = new_allocated;
+}
@@ -0,0 +1,139 @@
+#ifndef _book_array_hpp_
+#define _book_array_hpp_
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+
+#include "book.hpp"
+
+// The BookArray class is the array container behind BookList: a contiguous
+// run of books with a capacity chosen when it is constructed.
+//
+// Unlike std::array, the slots past size() are uninitialized storage, so a
+// large capacity costs nothing until books are actually inserted. Storage is
+// allocated on demand and grows geometrically up to the capacity.
+//
+// Storage comes from a std::pmr::memory_resource, which follows the rules of
+// the std::pmr containers: it is fixed when the array is constructed, copies
+// use the default resource unless given another, and assignment never
+// changes it.
+class BookArray {
+ public:
+  //
+  // Types and Constants
+  //
+
+  using iterator = Book*;
+  using const_iterator = const Book*;
+  using allocator_type = std::pmr::polymorphic_allocator<Book>;
+
+  // The capacity of an array that grows without limit.
+  static constexpr std::size_t unbounded_capacity = std::numeric_limits<std::size_t>::max();
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor constructs an empty array able to hold `capacity` books,
+  // allocating them from `resource`.
+  explicit BookArray(std::size_t capacity = unbounded_capacity,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
+
+  // The copy constructors construct an array as a copy of another array, with
+  // storage from the default resource or from `resource`.
+  BookArray(const BookArray& other);
+  BookArray(const BookArray& other, std::pmr::memory_resource* resource);
+
+  // The move constructor takes over the storage and the resource of another
+  // array, leaving it empty.
+  BookArray(BookArray&& other) noexcept;
+
+  // The copy assignment operator assigns the array a copy of another array.
+  BookArray& operator=(const BookArray& rhs);
+
+  // The move assignment operator takes over the storage of another array
+  // using the same resource, and otherwise moves its books one by one.
+  BookArray& operator=(BookArray&& rhs);
+
+  // The destructor.
+  ~BookArray() noexcept;
+
+  //
+  // Queries
+  //
+
+  // Returns the number of books in the array.
+  std::size_t size() const noexcept;
+
+  // Returns the most books the array may ever hold.
+  std::size_t capacity() const noexcept;
+
+  // Returns whether the array holds capacity() books.
+  bool full() const noexcept;
+
+  // Returns the allocator the books are allocated with.
+  allocator_type get_allocator() const noexcept;
+
+  // Returns the book at `offset`, which must be less than size().
+  Book& operator[](std::size_t offset) noexcept;
+  const Book& operator[](std::size_t offset) const noexcept;
+
+  // Iterators over the books in the array.
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+
+  //
+  // Mutators
+  //
+
+  // Inserts the book before the book at `offset`, shifting the books at and
+  // after it one slot to the right. The array must not be full and `offset`
+  // must not exceed size().
+  void insert(std::size_t offset, const Book& book);
+  void insert(std::size_t offset, Book&& book);
+
+  // Removes the book at `offset`, shifting the books after it one slot to the
+  // left. `offset` must be less than size().
+  void erase(std::size_t offset);
+
+  // Allocates room for at least `count` books (but never more than
+  // capacity()) so the next inserts do not need to grow the storage.
+  void reserve(std::size_t count);
+
+  // Removes every book. The capacity and allocated storage are kept.
+  void clear() noexcept;
+
+  // Swaps the contents and capacities of the two arrays, which must use the
+  // same resource.
+  void swap(BookArray& rhs) noexcept;
+
+ private:
+  // Makes room for at least one more book, growing the storage geometrically
+  // but never past capacity_.
+  void grow();
+
+  // Moves the books into new storage with `new_allocated` slots.
+  void reallocate(std::size_t new_allocated);
+
+  // Allocates the storage.
+  allocator_type allocator_;
+
+  // The uninitialized storage holding the books. Slots [0, size_) hold books.
+  Book* books_ = nullptr;
+
+  // The number of books in the array.
+  std::size_t size_ = 0;
+
+  // The number of slots allocated in books_.
+  std::size_t allocated_ = 0;
+
+  // The most books the array may ever hold.
+  std::size_t capacity_ = unbounded_capacity;
+};
+
+#endif
@@ -0,0 +1,127 @@
+// Unit tests for the BookArray class.
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+#include "allocation_counter.hpp"
+#include "book.hpp"
+#include "book_array.hpp"
+#include "doctest.hpp"
+
+TEST_CASE("BookArray") {
+  const Book book_1("book_1"),
+      book_2("book_2"),
+      book_3("book_3"),
+      book_4("book_4");
+
+  SUBCASE("DefaultConstructor") {
+    const BookArray array;
+    CHECK_EQ(0U, array.size());
+    CHECK_EQ(BookArray::unbounded_capacity, array.capacity());
+    CHECK_FALSE(array.full());
+    CHECK_EQ(array.begin(), array.end());
+  }
+
+  SUBCASE("LargeCapacityAllocatesNothingUpFront") {
+    const std::size_t allocations = allocation_counter::count([] {
+      const BookArray array(100000);
+      CHECK_EQ(100000U, array.capacity());
+    });
+    CHECK_EQ(0U, allocations);
+  }
+
+  SUBCASE("Insert") {
+    BookArray array(4);
+    array.insert(0, book_2);
+    array.insert(0, book_1);
+    array.insert(2, book_4);
+    array.insert(2, book_3);
+
+    REQUIRE_EQ(4U, array.size());
+    CHECK(array.full());
+    CHECK_EQ(book_1, array[0]);
+    CHECK_EQ(book_2, array[1]);
+    CHECK_EQ(book_3, array[2]);
+    CHECK_EQ(book_4, array[3]);
+  }
+
+  SUBCASE("InsertOwnElement") {
+    BookArray array;
+    array.insert(0, book_1);
+    array.insert(0, array[0]);
+    CHECK_EQ(2U, array.size());
+    CHECK_EQ(book_1, array[0]);
+    CHECK_EQ(book_1, array[1]);
+  }
+
+  SUBCASE("GrowsPastInitialAllocation") {
+    BookArray array;
+    for (int i = 0; i < 100; ++i) {
+      array.insert(0, Book("Book-" + std::to_string(i)));
+    }
+    REQUIRE_EQ(100U, array.size());
+    CHECK_EQ(Book("Book-99"), array[0]);
+    CHECK_EQ(Book("Book-0"), array[99]);
+  }
+
+  SUBCASE("Erase") {
+    BookArray array;
+    array.insert(0, book_1);
+    array.insert(1, book_2);
+    array.insert(2, book_3);
+
+    array.erase(1);
+    REQUIRE_EQ(2U, array.size());
+    CHECK_EQ(book_1, array[0]);
+    CHECK_EQ(book_3, array[1]);
+
+    array.erase(1);
+    array.erase(0);
+    CHECK_EQ(0U, array.size());
+  }
+
+  SUBCASE("CopyAndMove") {
+    BookArray array(3);
+    array.insert(0, book_1);
+    array.insert(1, book_2);
+
+    BookArray copy(array);
+    REQUIRE_EQ(2U, copy.size());
+    CHECK_EQ(3U, copy.capacity());
+    CHECK_EQ(book_2, copy[1]);
+
+    BookArray moved(std::move(array));
+    CHECK_EQ(2U, moved.size());
+    CHECK_EQ(0U, array.size());
+
+    copy.swap(moved);
+    copy = moved;
+    CHECK_EQ(2U, copy.size());
+    CHECK_EQ(book_1, copy[0]);
+  }
+
+  SUBCASE("MemoryResource") {
+    std::pmr::monotonic_buffer_resource arena;
+    BookArray array(BookArray::unbounded_capacity, &arena);
+    array.insert(0, book_1);
+    array.insert(1, book_2);
+    CHECK_EQ(&arena, array.get_allocator().resource());
+
+    // A copy uses the default resource unless given one.
+    const BookArray copy(array);
+    CHECK_EQ(std::pmr::get_default_resource(), copy.get_allocator().resource());
+    CHECK_EQ(&arena, BookArray(array, &arena).get_allocator().resource());
+
+    // Assignment keeps the resource and moves the books over one by one.
+    BookArray other;
+    other.insert(0, book_3);
+    other = std::move(array);
+    CHECK_EQ(std::pmr::get_default_resource(), other.get_allocator().resource());
+    REQUIRE_EQ(2U, other.size());
+    CHECK_EQ(book_1, other[0]);
+    CHECK_EQ(book_2, other[1]);
+    CHECK_EQ(0U, array.size());
+  }
+}
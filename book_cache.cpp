@@ -0,0 +1,132 @@
+#include "book_cache.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookCache::BookCache(std::size_t capacity, EvictionCallback on_eviction)
+    : capacity_(capacity),
+      on_eviction_(std::move(on_eviction)) {
+  if (capacity_ == 0) {
+    throw InvalidCapacityException("A BookCache must be able to hold at least one book");
+  }
+  books_by_isbn_.reserve(capacity_);
+}
+
+BookCache::~BookCache() = default;
+
+//
+// Queries
+//
+
+std::size_t BookCache::size() const {
+  return books_.size();
+}
+
+std::size_t BookCache::capacity() const {
+  return capacity_;
+}
+
+bool BookCache::contains(const std::string& isbn) const {
+  return books_by_isbn_.count(isbn) != 0;
+}
+
+BookList BookCache::books() const {
+  BookList books(BookList::unbounded_capacity);
+  books.append(books_.begin(), books_.end());
+  return books;
+}
+
+std::size_t BookCache::hits() const {
+  return hits_;
+}
+
+std::size_t BookCache::misses() const {
+  return misses_;
+}
+
+std::size_t BookCache::evictions() const {
+  return evictions_;
+}
+
+//
+// Mutators
+//
+
+bool BookCache::touch(const Book& book) {
+  const auto cached = books_by_isbn_.find(book.isbn());
+  if (cached != books_by_isbn_.end() && *cached->second == book) {
+    ++hits_;
+    books_.splice(books_.begin(), books_, cached->second);
+    return true;
+  }
+
+  ++misses_;
+  admit(book);
+  return false;
+}
+
+const Book& BookCache::get_or_load(const std::string& isbn, const Loader& loader) {
+  const auto cached = books_by_isbn_.find(isbn);
+  if (cached != books_by_isbn_.end()) {
+    ++hits_;
+    books_.splice(books_.begin(), books_, cached->second);
+    return *cached->second;
+  }
+
+  ++misses_;
+  const Book loaded = loader(isbn);
+  if (loaded.isbn() != isbn) {
+    throw IsbnMismatchException("Loaded book has ISBN \"" + loaded.isbn() + "\", not \"" + isbn + "\"");
+  }
+  return admit(loaded);
+}
+
+void BookCache::clear() {
+  books_by_isbn_.clear();
+  books_.clear();
+}
+
+void BookCache::reset_statistics() {
+  hits_ = misses_ = evictions_ = 0;
+}
+
+const Book& BookCache::admit(const Book& book) {
+  // Another edition of the book may be cached under the same ISBN, put there
+  // by touch() or by the loader itself.
+  if (const auto cached = books_by_isbn_.find(book.isbn()); cached != books_by_isbn_.end()) {
+    const auto node = cached->second;
+    books_by_isbn_.erase(cached);
+    books_.erase(node);
+  }
+
+  books_.push_front(book);
+  books_by_isbn_.emplace(books_.front().isbn(), books_.begin());
+
+  // The new book is at the front, so it is never the one evicted.
+  while (books_.size() > capacity_) {
+    evict();
+  }
+  return books_.front();
+}
+
+void BookCache::evict() {
+  // Take the book out of the cache before telling anyone, so the callback
+  // sees the cache as it will be. The map's key views the book's ISBN, so it
+  // goes before the book is moved out.
+  books_by_isbn_.erase(books_.back().isbn());
+  Book evicted = std::move(books_.back());
+  books_.pop_back();
+  ++evictions_;
+
+  if (on_eviction_) {
+    on_eviction_(evicted);
+  }
+}
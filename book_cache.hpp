@@ -0,0 +1,145 @@
+#ifndef _book_cache_hpp_
+#define _book_cache_hpp_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The BookCache class is a least-recently-used cache of books, keyed by ISBN.
+//
+// The cached books are kept in a std::list, most recently used at the front,
+// with a hash map from each ISBN to its node. Using a cached book splices its
+// node to the front, a new book is added there, and once the cache holds more
+// than capacity() books the one at the back is evicted. Each node holds the
+// only copy of its book, and the map keys are views of the books' ISBNs.
+//
+// touch() and get_or_load() therefore take constant time (expected, for the
+// hash map), plus the loader's time on a miss. Neither walks the cache nor copies
+// a cached book. A BookList could not offer this, since its move_to_top()
+// costs time proportional to the book's offset; books() copies the books into
+// one when a list is wanted.
+class BookCache {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  // Produces the book with the given ISBN when get_or_load() misses.
+  using Loader = std::function<Book(const std::string& isbn)>;
+
+  // Called with each book as it is evicted.
+  using EvictionCallback = std::function<void(const Book& evicted)>;
+
+  // Thrown if a cache is constructed with a capacity of zero.
+  struct InvalidCapacityException : std::invalid_argument {
+    using invalid_argument::invalid_argument;
+  };
+
+  // Thrown if get_or_load()'s loader produces a book with another ISBN.
+  struct IsbnMismatchException : std::invalid_argument {
+    using invalid_argument::invalid_argument;
+  };
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor constructs an empty cache holding up to `capacity`
+  // books, calling `on_eviction` (if set) with each book it evicts.
+  explicit BookCache(std::size_t capacity, EvictionCallback on_eviction = {});
+
+  // The map holds iterators into the list, which a copy would share, so a
+  // cache can be moved but not copied.
+  BookCache(const BookCache& other) = delete;
+  BookCache& operator=(const BookCache& rhs) = delete;
+  BookCache(BookCache&& other) = default;
+  BookCache& operator=(BookCache&& rhs) = default;
+
+  // The destructor.
+  ~BookCache();
+
+  //
+  // Queries
+  //
+
+  // Returns the number of books in the cache.
+  std::size_t size() const;
+
+  // Returns the most books the cache holds before evicting.
+  std::size_t capacity() const;
+
+  // Returns whether a book with the ISBN is cached. This does not count as a
+  // use of the book.
+  bool contains(const std::string& isbn) const;
+
+  // Returns a copy of the cached books, most recently used at the top.
+  // Takes time linear in size().
+  BookList books() const;
+
+  // Returns the number of lookups that found their book cached, that did
+  // not, and the number of books evicted, since construction or the last
+  // reset_statistics().
+  std::size_t hits() const;
+  std::size_t misses() const;
+  std::size_t evictions() const;
+
+  //
+  // Mutators
+  //
+
+  // Marks the book as the most recently used, adding it to the cache if it
+  // is not already there. A cached book with the same ISBN but different
+  // details is replaced. Returns whether the book was already cached.
+  bool touch(const Book& book);
+
+  // Returns the cached book with the ISBN, marking it the most recently used.
+  // On a miss, `loader` produces the book and it is cached first.
+  //
+  // Throws IsbnMismatchException, leaving the cache as the loader left it, if
+  // the loaded book has a different ISBN.
+  //
+  // The reference stays valid until the book is evicted or replaced, or the
+  // cache is cleared.
+  const Book& get_or_load(const std::string& isbn, const Loader& loader);
+
+  // Removes every book without calling the eviction callback.
+  void clear();
+
+  // Zeroes the hit, miss, and eviction counters.
+  void reset_statistics();
+
+ private:
+  // Adds the book at the front, replacing any book cached under its ISBN,
+  // then evicts from the back until the cache fits its capacity again.
+  // Returns the cached copy of the book.
+  const Book& admit(const Book& book);
+
+  // Evicts the least recently used book.
+  void evict();
+
+  // The most books the cache holds.
+  std::size_t capacity_;
+
+  // Called with each evicted book, if set.
+  EvictionCallback on_eviction_;
+
+  // The cached books in order of use, most recent at the front.
+  std::list<Book> books_;
+
+  // The node of each cached book, by a view of the book's ISBN.
+  std::unordered_map<std::string_view, std::list<Book>::iterator> books_by_isbn_;
+
+  // Counters reported by hits(), misses(), and evictions().
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+  std::size_t evictions_ = 0;
+};
+
+#endif
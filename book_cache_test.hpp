@@ -0,0 +1,117 @@
+// Unit tests for the BookCache class.
+
+#include <string>
+#include <vector>
+
+#include "book.hpp"
+#include "book_cache.hpp"
+#include "book_list.hpp"
+#include "doctest.hpp"
+
+TEST_CASE("BookCache") {
+  const Book book_1("title_1", "author", "isbn_1"),
+      book_2("title_2", "author", "isbn_2"),
+      book_3("title_3", "author", "isbn_3"),
+      book_4("title_4", "author", "isbn_4");
+
+  std::vector<Book> evicted;
+  BookCache cache(3, [&evicted](const Book& book) { evicted.push_back(book); });
+
+  SUBCASE("RejectsZeroCapacity") {
+    CHECK_THROWS_AS(BookCache(0), BookCache::InvalidCapacityException);
+  }
+
+  SUBCASE("TouchCountsHitsAndMisses") {
+    CHECK_FALSE(cache.touch(book_1));
+    CHECK_FALSE(cache.touch(book_2));
+    CHECK(cache.touch(book_1));
+
+    CHECK_EQ(1U, cache.hits());
+    CHECK_EQ(2U, cache.misses());
+    CHECK_EQ(2U, cache.size());
+    CHECK_EQ(BookList({book_1, book_2}), cache.books());
+  }
+
+  SUBCASE("EvictsLeastRecentlyUsed") {
+    cache.touch(book_1);
+    cache.touch(book_2);
+    cache.touch(book_3);
+    cache.touch(book_1);
+    cache.touch(book_4);
+
+    CHECK_EQ(3U, cache.size());
+    CHECK_EQ(1U, cache.evictions());
+    REQUIRE_EQ(1U, evicted.size());
+    CHECK_EQ(book_2, evicted.front());
+    CHECK_FALSE(cache.contains("isbn_2"));
+    CHECK_EQ(BookList({book_4, book_1, book_3}), cache.books());
+  }
+
+  SUBCASE("GetOrLoad") {
+    int loads = 0;
+    const BookCache::Loader loader = [&loads](const std::string& isbn) {
+      ++loads;
+      return Book("loaded " + isbn, "author", isbn);
+    };
+
+    const Book& loaded = cache.get_or_load("isbn_9", loader);
+    CHECK_EQ("loaded isbn_9", loaded.title());
+    cache.touch(book_1);
+    CHECK_EQ(&loaded, &cache.get_or_load("isbn_9", loader));
+    CHECK_EQ(1, loads);
+    CHECK_EQ(1U, cache.hits());
+    CHECK_EQ(2U, cache.misses());
+
+    cache.touch(book_2);
+    cache.touch(book_3);
+    cache.touch(book_4);
+    CHECK_FALSE(cache.contains("isbn_9"));
+    CHECK_EQ(2U, cache.evictions());
+  }
+
+  SUBCASE("ReplacesOtherEdition") {
+    cache.touch(book_1);
+    const Book new_edition("title_1, second edition", "author", "isbn_1");
+    CHECK_FALSE(cache.touch(new_edition));
+    CHECK_EQ(1U, cache.size());
+    CHECK_EQ(BookList({new_edition}), cache.books());
+    CHECK(evicted.empty());
+  }
+
+  SUBCASE("RejectsLoadedBookWithOtherIsbn") {
+    cache.touch(book_1);
+    const BookCache::Loader wrong = [&book_2](const std::string&) { return book_2; };
+    CHECK_THROWS_AS(cache.get_or_load("isbn_9", wrong), BookCache::IsbnMismatchException);
+    CHECK_EQ(1U, cache.size());
+    CHECK_FALSE(cache.contains("isbn_2"));
+    CHECK_FALSE(cache.contains("isbn_9"));
+    CHECK_EQ(BookList({book_1}), cache.books());
+  }
+
+  SUBCASE("LoaderReplacesOtherEdition") {
+    // A loader that caches an older edition on its way to the new one.
+    const Book new_edition("title_1, second edition", "author", "isbn_1");
+    const BookCache::Loader loader = [&](const std::string&) {
+      cache.touch(book_1);
+      cache.touch(book_2);
+      return new_edition;
+    };
+    CHECK_EQ(new_edition, cache.get_or_load("isbn_1", loader));
+    CHECK_EQ(2U, cache.size());
+    CHECK_EQ(BookList({new_edition, book_2}), cache.books());
+    CHECK_EQ(new_edition, cache.get_or_load("isbn_1", loader));
+    CHECK_EQ(1U, cache.hits());
+    CHECK(evicted.empty());
+  }
+
+  SUBCASE("ClearAndResetStatistics") {
+    cache.touch(book_1);
+    cache.touch(book_1);
+    cache.clear();
+    cache.reset_statistics();
+    CHECK_EQ(0U, cache.size());
+    CHECK_EQ(0U, cache.hits());
+    CHECK_EQ(0U, cache.misses());
+    CHECK_FALSE(cache.touch(book_1));
+  }
+}
@@ -0,0 +1,258 @@
+#include "book_chunks.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "book.hpp"
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookChunks::BookChunks(std::pmr::memory_resource* resource)
+    : chunks_(resource), counts_(1, 0, resource) {}
+
+BookChunks::BookChunks(const BookChunks& other)
+    : BookChunks(other, std::pmr::get_default_resource()) {}
+
+BookChunks::BookChunks(const BookChunks& other, std::pmr::memory_resource* resource)
+    : chunks_(other.chunks_, resource),
+      counts_(other.counts_, resource),
+      size_(other.size_),
+      cursor_chunk_(other.cursor_chunk_),
+      cursor_first_(other.cursor_first_) {}
+
+BookChunks::BookChunks(BookChunks&& other) noexcept
+    : chunks_(std::move(other.chunks_)),
+      counts_(std::move(other.counts_)),
+      size_(std::exchange(other.size_, 0)),
+      cursor_chunk_(std::exchange(other.cursor_chunk_, 0)),
+      cursor_first_(std::exchange(other.cursor_first_, 0)) {
+  other.clear();
+}
+
+BookChunks& BookChunks::operator=(const BookChunks& rhs) = default;
+
+BookChunks& BookChunks::operator=(BookChunks&& rhs) {
+  if (this != &rhs) {
+    chunks_ = std::move(rhs.chunks_);
+    counts_ = std::move(rhs.counts_);
+    size_ = rhs.size_;
+    cursor_chunk_ = rhs.cursor_chunk_;
+    cursor_first_ = rhs.cursor_first_;
+    rhs.clear();
+  }
+  return *this;
+}
+
+BookChunks::~BookChunks() noexcept = default;
+
+//
+// Queries
+//
+
+std::size_t BookChunks::size() const noexcept {
+  return size_;
+}
+
+BookChunks::allocator_type BookChunks::get_allocator() const noexcept {
+  return allocator_type(chunks_.get_allocator().resource());
+}
+
+Book& BookChunks::operator[](std::size_t offset) noexcept {
+  const Location location = locate(offset);
+  return chunks_[location.chunk][location.index];
+}
+
+const Book& BookChunks::operator[](std::size_t offset) const noexcept {
+  const Location location = locate(offset);
+  return chunks_[location.chunk][location.index];
+}
+
+BookChunks::const_iterator BookChunks::begin() const noexcept {
+  return const_iterator(this, 0);
+}
+
+BookChunks::const_iterator BookChunks::end() const noexcept {
+  return const_iterator(this, size_);
+}
+
+BookChunks::const_iterator BookChunks::cbegin() const noexcept {
+  return begin();
+}
+
+BookChunks::const_iterator BookChunks::cend() const noexcept {
+  return end();
+}
+
+BookChunks::const_iterator::const_iterator(const BookChunks* owner, std::size_t offset) noexcept
+    : owner_(owner), offset_(offset) {
+  if (offset < owner->size_) {
+    const Location location = owner->locate(offset);
+    chunk_ = location.chunk;
+    index_ = location.index;
+  } else {
+    chunk_ = owner->chunks_.size();
+  }
+}
+
+//
+// Mutators
+//
+
+void BookChunks::insert(std::size_t offset, const Book& book) {
+  insert(offset, Book(book));
+}
+
+void BookChunks::insert(std::size_t offset, Book&& book) {
+  const Location location = make_room(offset);
+  std::pmr::vector<Book>& chunk = chunks_[location.chunk];
+  chunk.insert(std::next(chunk.begin(), location.index), std::move(book));
+  increment_count(location.chunk);
+  ++size_;
+  cursor_chunk_ = location.chunk;
+  cursor_first_ = offset - location.index;
+}
+
+void BookChunks::erase(std::size_t offset) {
+  const Location location = locate(offset);
+  std::pmr::vector<Book>& chunk = chunks_[location.chunk];
+  chunk.erase(std::next(chunk.begin(), location.index));
+  --size_;
+
+  // An emptied chunk is dropped, and the one after it, if any, now starts at
+  // the same offset and becomes the cursor.
+  if (chunk.empty()) {
+    chunks_.erase(std::next(chunks_.begin(), location.chunk));
+    rebuild_counts();
+  } else {
+    decrement_count(location.chunk);
+  }
+  cursor_chunk_ = location.chunk;
+  cursor_first_ = offset - location.index;
+}
+
+void BookChunks::move_to_front(std::size_t offset) {
+  const Location location = locate(offset);
+  Book book = std::move(chunks_[location.chunk][location.index]);
+  erase(offset);
+  insert(0, std::move(book));
+}
+
+void BookChunks::clear() noexcept {
+  chunks_.clear();
+  counts_.assign(1, 0);
+  size_ = 0;
+  cursor_chunk_ = 0;
+  cursor_first_ = 0;
+}
+
+void BookChunks::swap(BookChunks& rhs) noexcept {
+  chunks_.swap(rhs.chunks_);
+  counts_.swap(rhs.counts_);
+  std::swap(size_, rhs.size_);
+  std::swap(cursor_chunk_, rhs.cursor_chunk_);
+  std::swap(cursor_first_, rhs.cursor_first_);
+}
+
+//
+// Chunks and Counts
+//
+
+BookChunks::Location BookChunks::locate(std::size_t offset) const noexcept {
+  // Most edits land in the chunk the last one did.
+  if (cursor_chunk_ < chunks_.size() && offset >= cursor_first_
+      && offset - cursor_first_ < chunks_[cursor_chunk_].size()) {
+    return {cursor_chunk_, offset - cursor_first_};
+  }
+
+  // Otherwise descend the tree, from the largest power of two not above the
+  // number of chunks, past every subtree of chunks that all lie above the
+  // offset.
+  const std::size_t chunks = chunks_.size();
+  std::size_t step = 1;
+  while (step * 2 <= chunks) {
+    step *= 2;
+  }
+  std::size_t chunk = 0;
+  std::size_t remaining = offset;
+  for (; step != 0; step /= 2) {
+    if (chunk + step <= chunks && counts_[chunk + step] <= remaining) {
+      chunk += step;
+      remaining -= counts_[chunk];
+    }
+  }
+  return {chunk, remaining};
+}
+
+BookChunks::Location BookChunks::make_room(std::size_t offset) {
+  if (chunks_.empty()) {
+    chunks_.emplace_back();
+    chunks_.back().reserve(chunk_capacity);
+    rebuild_counts();
+  }
+
+  // The bottom of the list is the end of the last chunk.
+  Location location = offset < size_
+      ? locate(offset)
+      : Location{chunks_.size() - 1, chunks_.back().size()};
+
+  // A book going to the front of a chunk can join the end of the one before
+  // it instead, if that one has room.
+  if (location.index == 0 && location.chunk != 0
+      && chunks_[location.chunk - 1].size() < chunk_capacity) {
+    --location.chunk;
+    location.index = chunks_[location.chunk].size();
+  }
+
+  if (chunks_[location.chunk].size() == chunk_capacity) {
+    split(location.chunk);
+    if (location.index > chunk_capacity / 2) {
+      ++location.chunk;
+      location.index -= chunk_capacity / 2;
+    }
+  }
+  return location;
+}
+
+void BookChunks::split(std::size_t chunk) {
+  // The upper half moves to a new chunk right after this one. Moving a chunk
+  // within chunks_ moves only its handle, as both use the same resource.
+  std::pmr::vector<Book> upper(chunks_.get_allocator().resource());
+  upper.reserve(chunk_capacity);
+  std::pmr::vector<Book>& lower = chunks_[chunk];
+  const auto middle = std::next(lower.begin(), chunk_capacity / 2);
+  upper.insert(upper.end(), std::make_move_iterator(middle), std::make_move_iterator(lower.end()));
+  lower.erase(middle, lower.end());
+  chunks_.insert(std::next(chunks_.begin(), chunk + 1), std::move(upper));
+  rebuild_counts();
+}
+
+void BookChunks::increment_count(std::size_t chunk) noexcept {
+  for (std::size_t node = chunk + 1; node < counts_.size(); node += node & (~node + 1)) {
+    ++counts_[node];
+  }
+}
+
+void BookChunks::decrement_count(std::size_t chunk) noexcept {
+  for (std::size_t node = chunk + 1; node < counts_.size(); node += node & (~node + 1)) {
+    --counts_[node];
+  }
+}
+
+void BookChunks::rebuild_counts() {
+  // Each node adds its total to its parent once it is complete, so the tree
+  // is built in one pass.
+  counts_.assign(chunks_.size() + 1, 0);
+  for (std::size_t node = 1; node < counts_.size(); ++node) {
+    counts_[node] += chunks_[node - 1].size();
+    const std::size_t parent = node + (node & (~node + 1));
+    if (parent < counts_.size()) {
+      counts_[parent] += counts_[node];
+    }
+  }
+}
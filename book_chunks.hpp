@@ -0,0 +1,297 @@
+#ifndef _book_chunks_hpp_
+#define _book_chunks_hpp_
+
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <vector>
+
+#include "book.hpp"
+
+// The BookChunks class is the chunked container behind BookList: the books in
+// order, cut into chunks of at most chunk_capacity books each, like an
+// unrolled linked list whose chunks are reached through an index.
+//
+// Inserting or removing a book shifts only the books after it in its own
+// chunk, never more than chunk_capacity of them. A full chunk is split in
+// two, and an empty one is dropped. Offsets are found through a Fenwick tree
+// (binary indexed tree) of the chunk sizes in logarithmic time, or in
+// constant time when they fall in the chunk last edited, so edits near the
+// same cursor do not search at all. Keeping the tree current costs each edit
+// logarithmic time, and rebuilding it after a split or a dropped chunk costs
+// time in proportion to the number of chunks, once every chunk_capacity / 2
+// edits at worst.
+//
+// Storage comes from a std::pmr::memory_resource, which follows the rules of
+// the std::pmr containers: it is fixed when the container is constructed,
+// copies use the default resource unless given another, and assignment never
+// changes it.
+class BookChunks {
+ public:
+  //
+  // Types and Constants
+  //
+
+  // A random access iterator over the books. Stepping it costs constant
+  // time; jumping by an offset finds the chunk as operator[] does.
+  class const_iterator;
+  using iterator = const_iterator;
+  using allocator_type = std::pmr::polymorphic_allocator<Book>;
+
+  // The most books a chunk holds.
+  static constexpr std::size_t chunk_capacity = 128;
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor constructs an empty container allocating from
+  // `resource`.
+  explicit BookChunks(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  // The copy constructors construct a container as a copy of another one,
+  // with storage from the default resource or from `resource`.
+  BookChunks(const BookChunks& other);
+  BookChunks(const BookChunks& other, std::pmr::memory_resource* resource);
+
+  // The move constructor takes over the storage and the resource of another
+  // container, leaving it empty.
+  BookChunks(BookChunks&& other) noexcept;
+
+  // The copy assignment operator assigns the container a copy of another one.
+  BookChunks& operator=(const BookChunks& rhs);
+
+  // The move assignment operator takes over the storage of another container
+  // using the same resource, and otherwise moves its books one by one.
+  BookChunks& operator=(BookChunks&& rhs);
+
+  // The destructor.
+  ~BookChunks() noexcept;
+
+  //
+  // Queries
+  //
+
+  // Returns the number of books in the container.
+  std::size_t size() const noexcept;
+
+  // Returns the allocator the books are allocated with.
+  allocator_type get_allocator() const noexcept;
+
+  // Returns the book at `offset`, which must be less than size().
+  Book& operator[](std::size_t offset) noexcept;
+  const Book& operator[](std::size_t offset) const noexcept;
+
+  // Iterators over the books in the container.
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+
+  //
+  // Mutators
+  //
+
+  // Inserts the book before the book at `offset`, which must not exceed
+  // size().
+  void insert(std::size_t offset, const Book& book);
+  void insert(std::size_t offset, Book&& book);
+
+  // Removes the book at `offset`, which must be less than size().
+  void erase(std::size_t offset);
+
+  // Moves the book at `offset`, which must be less than size(), to the front
+  // without copying it.
+  void move_to_front(std::size_t offset);
+
+  // Removes every book.
+  void clear() noexcept;
+
+  // Swaps the contents of the two containers, which must use the same
+  // resource.
+  void swap(BookChunks& rhs) noexcept;
+
+ private:
+  // Where a book is: its chunk, and its offset within the chunk.
+  struct Location {
+    std::size_t chunk;
+    std::size_t index;
+  };
+
+  // Returns where the book at `offset`, which must be less than size(), is.
+  Location locate(std::size_t offset) const noexcept;
+
+  // Returns where a book inserted at `offset` goes, making room for it.
+  Location make_room(std::size_t offset);
+
+  // Splits the full chunk at `chunk` into two halves.
+  void split(std::size_t chunk);
+
+  // Adds one to, or takes one from, the size of `chunk` in the tree.
+  void increment_count(std::size_t chunk) noexcept;
+  void decrement_count(std::size_t chunk) noexcept;
+
+  // Rebuilds the tree from the chunk sizes.
+  void rebuild_counts();
+
+  // The chunks, none of them empty.
+  std::pmr::vector<std::pmr::vector<Book>> chunks_;
+
+  // The Fenwick tree of chunk sizes: counts_[i] holds the total size of the
+  // i & -i chunks ending with chunk i - 1. counts_[0] is unused.
+  std::pmr::vector<std::size_t> counts_;
+
+  // The number of books in all the chunks.
+  std::size_t size_ = 0;
+
+  // The chunk last edited and the offset of its first book. Only the
+  // mutators move it, so const queries stay free of shared mutable state.
+  std::size_t cursor_chunk_ = 0;
+  std::size_t cursor_first_ = 0;
+};
+
+class BookChunks::const_iterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = Book;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Book*;
+  using reference = const Book&;
+
+  const_iterator() noexcept = default;
+
+  reference operator*() const noexcept;
+  pointer operator->() const noexcept;
+  reference operator[](difference_type distance) const noexcept;
+
+  const_iterator& operator++() noexcept;
+  const_iterator operator++(int) noexcept;
+  const_iterator& operator--() noexcept;
+  const_iterator operator--(int) noexcept;
+
+  const_iterator& operator+=(difference_type distance) noexcept;
+  const_iterator& operator-=(difference_type distance) noexcept;
+  const_iterator operator+(difference_type distance) const noexcept;
+  const_iterator operator-(difference_type distance) const noexcept;
+  friend const_iterator operator+(difference_type distance, const const_iterator& iterator) noexcept {
+    return iterator + distance;
+  }
+  difference_type operator-(const const_iterator& rhs) const noexcept;
+
+  bool operator==(const const_iterator& rhs) const noexcept;
+  bool operator!=(const const_iterator& rhs) const noexcept;
+  bool operator<(const const_iterator& rhs) const noexcept;
+  bool operator<=(const const_iterator& rhs) const noexcept;
+  bool operator>(const const_iterator& rhs) const noexcept;
+  bool operator>=(const const_iterator& rhs) const noexcept;
+
+ private:
+  friend class BookChunks;
+
+  // Positions the iterator on the book at `offset`, or past the last book.
+  const_iterator(const BookChunks* owner, std::size_t offset) noexcept;
+
+  const BookChunks* owner_ = nullptr;
+  std::size_t chunk_ = 0;
+  std::size_t index_ = 0;
+  std::size_t offset_ = 0;
+};
+
+//
+// Iterator Member Definitions
+//
+
+// Stepping and dereferencing are defined here, so loops over a BookList whose
+// primary container is the chunked one inline them as they do a pointer.
+
+inline BookChunks::const_iterator::reference BookChunks::const_iterator::operator*() const noexcept {
+  return owner_->chunks_[chunk_][index_];
+}
+
+inline BookChunks::const_iterator::pointer BookChunks::const_iterator::operator->() const noexcept {
+  return &**this;
+}
+
+inline BookChunks::const_iterator::reference BookChunks::const_iterator::operator[](difference_type distance) const noexcept {
+  return *(*this + distance);
+}
+
+inline BookChunks::const_iterator& BookChunks::const_iterator::operator++() noexcept {
+  ++offset_;
+  if (++index_ == owner_->chunks_[chunk_].size()) {
+    ++chunk_;
+    index_ = 0;
+  }
+  return *this;
+}
+
+inline BookChunks::const_iterator BookChunks::const_iterator::operator++(int) noexcept {
+  const_iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+inline BookChunks::const_iterator& BookChunks::const_iterator::operator--() noexcept {
+  --offset_;
+  if (index_ == 0) {
+    --chunk_;
+    index_ = owner_->chunks_[chunk_].size();
+  }
+  --index_;
+  return *this;
+}
+
+inline BookChunks::const_iterator BookChunks::const_iterator::operator--(int) noexcept {
+  const_iterator previous = *this;
+  --*this;
+  return previous;
+}
+
+inline BookChunks::const_iterator& BookChunks::const_iterator::operator+=(difference_type distance) noexcept {
+  *this = const_iterator(owner_, offset_ + static_cast<std::size_t>(distance));
+  return *this;
+}
+
+inline BookChunks::const_iterator& BookChunks::const_iterator::operator-=(difference_type distance) noexcept {
+  return *this += -distance;
+}
+
+inline BookChunks::const_iterator BookChunks::const_iterator::operator+(difference_type distance) const noexcept {
+  const_iterator moved = *this;
+  return moved += distance;
+}
+
+inline BookChunks::const_iterator BookChunks::const_iterator::operator-(difference_type distance) const noexcept {
+  const_iterator moved = *this;
+  return moved -= distance;
+}
+
+inline BookChunks::const_iterator::difference_type BookChunks::const_iterator::operator-(const const_iterator& rhs) const noexcept {
+  return static_cast<difference_type>(offset_) - static_cast<difference_type>(rhs.offset_);
+}
+
+inline bool BookChunks::const_iterator::operator==(const const_iterator& rhs) const noexcept {
+  return offset_ == rhs.offset_;
+}
+
+inline bool BookChunks::const_iterator::operator!=(const const_iterator& rhs) const noexcept {
+  return offset_ != rhs.offset_;
+}
+
+inline bool BookChunks::const_iterator::operator<(const const_iterator& rhs) const noexcept {
+  return offset_ < rhs.offset_;
+}
+
+inline bool BookChunks::const_iterator::operator<=(const const_iterator& rhs) const noexcept {
+  return offset_ <= rhs.offset_;
+}
+
+inline bool BookChunks::const_iterator::operator>(const const_iterator& rhs) const noexcept {
+  return offset_ > rhs.offset_;
+}
+
+inline bool BookChunks::const_iterator::operator>=(const const_iterator& rhs) const noexcept {
+  return offset_ >= rhs.offset_;
+}
+
+#endif
@@ -0,0 +1,179 @@
+// Unit tests for the BookChunks class.
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocation_counter.hpp"
+#include "book.hpp"
+#include "book_chunks.hpp"
+#include "doctest.hpp"
+
+namespace {
+  // Returns whether `chunks` holds the books of `expected`, in order, both
+  // through operator[] and through its iterators.
+  bool holds(const BookChunks& chunks, const std::vector<Book>& expected) {
+    if (chunks.size() != expected.size()
+        || !std::equal(chunks.begin(), chunks.end(), expected.begin(), expected.end())) {
+      return false;
+    }
+    for (std::size_t offset = 0; offset < expected.size(); ++offset) {
+      if (chunks[offset] != expected[offset]) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+TEST_CASE("BookChunks") {
+  const Book book_1("book_1"),
+      book_2("book_2"),
+      book_3("book_3"),
+      book_4("book_4");
+
+  // Enough books to fill several chunks.
+  std::vector<Book> books;
+  for (std::size_t i = 0; i < 5 * BookChunks::chunk_capacity; ++i) {
+    books.emplace_back("title", "author", std::to_string(i));
+  }
+
+  SUBCASE("DefaultConstructor") {
+    const BookChunks chunks;
+    CHECK_EQ(0U, chunks.size());
+    CHECK_EQ(chunks.begin(), chunks.end());
+  }
+
+  SUBCASE("Insert") {
+    BookChunks chunks;
+    chunks.insert(0, book_2);
+    chunks.insert(0, book_1);
+    chunks.insert(2, book_4);
+    chunks.insert(2, book_3);
+    CHECK(holds(chunks, {book_1, book_2, book_3, book_4}));
+  }
+
+  SUBCASE("InsertAcrossChunks") {
+    // Books added at the bottom, at the top and in the middle split chunks in
+    // every position.
+    BookChunks chunks;
+    std::vector<Book> expected;
+    for (std::size_t i = 0; i < books.size(); ++i) {
+      const std::size_t offset = i % 3 == 0 ? 0 : i % 3 == 1 ? expected.size() : expected.size() / 2;
+      chunks.insert(offset, books[i]);
+      expected.insert(std::next(expected.begin(), static_cast<std::ptrdiff_t>(offset)), books[i]);
+    }
+    CHECK(holds(chunks, expected));
+  }
+
+  SUBCASE("InsertNearCursor") {
+    // Typing at a cursor that moves down by one after each book.
+    BookChunks chunks;
+    std::vector<Book> expected;
+    for (std::size_t i = 0; i < books.size(); ++i) {
+      const std::size_t offset = i / 2;
+      chunks.insert(offset, books[i]);
+      expected.insert(std::next(expected.begin(), static_cast<std::ptrdiff_t>(offset)), books[i]);
+    }
+    CHECK(holds(chunks, expected));
+  }
+
+  SUBCASE("Erase") {
+    BookChunks chunks;
+    for (std::size_t i = 0; i < books.size(); ++i) {
+      chunks.insert(i, books[i]);
+    }
+    std::vector<Book> expected = books;
+
+    // Erasing every other book from the middle, then a whole chunk's worth
+    // from the top, drops emptied chunks along the way.
+    for (std::size_t offset = expected.size() / 4; offset < expected.size() / 2; ++offset) {
+      chunks.erase(offset);
+      expected.erase(std::next(expected.begin(), static_cast<std::ptrdiff_t>(offset)));
+    }
+    for (std::size_t i = 0; i < BookChunks::chunk_capacity + 1; ++i) {
+      chunks.erase(0);
+      expected.erase(expected.begin());
+    }
+    CHECK(holds(chunks, expected));
+
+    while (chunks.size() != 0) {
+      chunks.erase(chunks.size() - 1);
+    }
+    CHECK_EQ(chunks.begin(), chunks.end());
+  }
+
+  SUBCASE("MoveToFront") {
+    BookChunks chunks;
+    for (std::size_t i = 0; i < books.size(); ++i) {
+      chunks.insert(i, books[i]);
+    }
+    chunks.move_to_front(300);
+    chunks.move_to_front(0);
+    chunks.move_to_front(books.size() - 1);
+
+    std::vector<Book> expected = books;
+    std::rotate(expected.begin(), std::next(expected.begin(), 300), std::next(expected.begin(), 301));
+    std::rotate(expected.begin(), std::prev(expected.end()), expected.end());
+    CHECK(holds(chunks, expected));
+  }
+
+  SUBCASE("RandomAccessIterators") {
+    BookChunks chunks;
+    for (std::size_t i = 0; i < books.size(); ++i) {
+      chunks.insert(i, books[i]);
+    }
+    auto position = chunks.begin() + 200;
+    CHECK_EQ(books[200], *position);
+    CHECK_EQ(books[199], *--position);
+    CHECK_EQ(books[330], position[131]);
+    CHECK_EQ(static_cast<std::ptrdiff_t>(books.size()), chunks.end() - chunks.begin());
+    CHECK_EQ(books.back(), *std::prev(chunks.end()));
+    CHECK(chunks.begin() < position);
+  }
+
+  SUBCASE("CopyAndMove") {
+    BookChunks chunks;
+    for (std::size_t i = 0; i < books.size(); ++i) {
+      chunks.insert(i, books[i]);
+    }
+
+    BookChunks copy(chunks);
+    CHECK(holds(copy, books));
+    copy.insert(0, book_1);
+    CHECK(holds(chunks, books));
+
+    BookChunks moved(std::move(copy));
+    CHECK_EQ(books.size() + 1, moved.size());
+    CHECK_EQ(0U, copy.size());
+
+    copy = chunks;
+    CHECK(holds(copy, books));
+    moved = std::move(copy);
+    CHECK(holds(moved, books));
+  }
+
+  SUBCASE("MemoryResource") {
+    // With no upstream resource, any allocation the buffer cannot serve
+    // throws. Titles and authors are pooled and the ISBNs fit the small
+    // string buffer, so only the chunks and the tree allocate.
+    alignas(std::max_align_t) static unsigned char buffer[1024 * 1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    BookChunks chunks(&arena);
+    const std::size_t allocations = allocation_counter::count([&] {
+      for (std::size_t i = 0; i < books.size(); ++i) {
+        chunks.insert(i / 2, books[i]);
+      }
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ(&arena, chunks.get_allocator().resource());
+
+    const BookChunks copy(chunks, &arena);
+    CHECK_EQ(&arena, copy.get_allocator().resource());
+    CHECK(std::equal(copy.begin(), copy.end(), chunks.begin(), chunks.end()));
+  }
+}
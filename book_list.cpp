@@ -1,44 +1,452 @@
 #include <algorithm>
+#include <atomic>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iomanip>
 #include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "book.hpp"
 #include "book_list.hpp"
 
+namespace {
+  // Returns whether `storage` is the last of the stored containers a new book
+  // is inserted into, and so can take the original instead of a copy.
+  constexpr bool receives_book_last(int storage) {
+    return (BOOK_LIST_STORAGE & ~((storage << 1) - 1)) == 0;
+  }
+
+  // Appends `number` to `buffer`, right-aligned in `width` columns as
+  // std::setw() would pad it.
+  void append_number(std::string& buffer, std::size_t number, std::size_t width = 0) {
+    char digits[std::numeric_limits<std::size_t>::digits10 + 1];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    const std::size_t length = result.ptr - digits;
+    if (length < width) {
+      buffer.append(width - length, ' ');
+    }
+    buffer.append(digits, length);
+  }
+
+  // Returns the lowest offset in [0, count) for which `matches` returns true,
+  // or `count` if there is none.
+  //
+  // From BOOK_LIST_PARALLEL_THRESHOLD offsets on, the range is cut into one
+  // slice per thread. A thread stops at its first match, recording it if it
+  // is the lowest so far, and gives up early once a match below the offset it
+  // has reached is recorded, since it could then only find higher ones.
+  template <typename Matches>
+  std::size_t find_first(std::size_t count, const Matches& matches) {
+    const std::size_t threads = BOOK_LIST_PARALLEL_THREADS != 0
+        ? BOOK_LIST_PARALLEL_THREADS
+        : std::thread::hardware_concurrency();
+    if (count < BOOK_LIST_PARALLEL_THRESHOLD || threads < 2) {
+      std::size_t offset = 0;
+      while (offset != count && !matches(offset)) {
+        ++offset;
+      }
+      return offset;
+    }
+
+    std::atomic<std::size_t> first_match{count};
+    const std::size_t slice = (count + threads - 1) / threads;
+    const auto scan = [&](std::size_t begin) {
+      const std::size_t end = std::min(begin + slice, count);
+      for (std::size_t offset = begin; offset < end; ++offset) {
+        if (offset % 1024 == 0 && first_match.load(std::memory_order_relaxed) < offset) {
+          return;
+        }
+        if (matches(offset)) {
+          std::size_t lowest = first_match.load(std::memory_order_relaxed);
+          while (offset < lowest && !first_match.compare_exchange_weak(lowest, offset)) {
+          }
+          return;
+        }
+      }
+    };
+
+    // A slice that cannot get a thread of its own is scanned on this one.
+    std::vector<std::thread> helpers;
+    helpers.reserve(threads - 1);
+    for (std::size_t thread = 1; thread < threads; ++thread) {
+      try {
+        helpers.emplace_back(scan, thread * slice);
+      } catch (const std::system_error&) {
+        scan(thread * slice);
+      }
+    }
+    scan(0);
+    for (std::thread& helper : helpers) {
+      helper.join();
+    }
+    return first_match.load();
+  }
+
+  // Returns the book `offset` places past `books`. Only used on the vector and
+  // the array, where this is constant time, but std::next keeps the branches
+  // that call it compiling for list and chunked storage, where they are
+  // discarded.
+  template <typename Iterator>
+  const Book& book_at(Iterator books, std::size_t offset) {
+    return *std::next(books, static_cast<std::ptrdiff_t>(offset));
+  }
+
+  // Order the keys of the ordered indexes: prices by value, and interned
+  // strings by their text, which may also be given as a plain view.
+  bool key_less(double lhs, double rhs) noexcept {
+    return lhs < rhs;
+  }
+
+  bool key_less(const std::string* lhs, const std::string* rhs) noexcept {
+    return *lhs < *rhs;
+  }
+
+#if BOOK_LIST_ORDERED_INDEXES
+  bool key_less(const std::string* lhs, std::string_view rhs) noexcept {
+    return std::string_view(*lhs) < rhs;
+  }
+
+  bool key_less(std::string_view lhs, const std::string* rhs) noexcept {
+    return lhs < std::string_view(*rhs);
+  }
+#endif
+
+  // Orders index entries by key, then by offset.
+  struct EntryLess {
+    template <typename Entry>
+    bool operator()(const Entry& lhs, const Entry& rhs) const noexcept {
+      return key_less(lhs.key, rhs.key)
+          || (!key_less(rhs.key, lhs.key) && lhs.offset < rhs.offset);
+    }
+  };
+
+  // Adds an entry for the book at `offset` to `index`, after moving the
+  // entries at and below it down by one. Moving them all keeps their order.
+  template <typename Index, typename Key>
+  void add_entry(Index& index, Key key, std::size_t offset) {
+    for (auto& entry : index) {
+      if (entry.offset >= offset) {
+        ++entry.offset;
+      }
+    }
+    const typename Index::value_type added{key, offset};
+    index.insert(std::lower_bound(index.begin(), index.end(), added, EntryLess()), added);
+  }
+
+  // Removes the entry for the book at `offset` from `index`, then moves the
+  // entries below it up by one.
+  template <typename Index, typename Key>
+  void remove_entry(Index& index, Key key, std::size_t offset) {
+    const typename Index::value_type removed{key, offset};
+    index.erase(std::lower_bound(index.begin(), index.end(), removed, EntryLess()));
+    for (auto& entry : index) {
+      if (entry.offset > offset) {
+        --entry.offset;
+      }
+    }
+  }
+
+  // Returns the offsets of the entries of `index` with keys from `low` to
+  // `high` inclusive, in index order.
+  template <typename Index, typename Probe>
+  std::vector<std::size_t> offsets_between(const Index& index, const Probe& low, const Probe& high) {
+    using Entry = typename Index::value_type;
+    const auto first = std::lower_bound(index.begin(), index.end(), low,
+        [](const Entry& entry, const Probe& probe) { return key_less(entry.key, probe); });
+    const auto last = std::upper_bound(first, index.end(), high,
+        [](const Probe& probe, const Entry& entry) { return key_less(probe, entry.key); });
+
+    std::vector<std::size_t> offsets;
+    offsets.reserve(static_cast<std::size_t>(last - first));
+    for (auto entry = first; entry != last; ++entry) {
+      offsets.push_back(entry->offset);
+    }
+    return offsets;
+  }
+
+  // The number of containers BOOK_LIST_STORAGE keeps the books in.
+  constexpr std::size_t stored_containers = BookList::stores_array + BookList::stores_vector
+      + BookList::stores_sl_list + BookList::stores_dl_list + BookList::stores_chunked;
+
+  // The number of contiguous containers, which shift books to open or close
+  // a gap.
+  constexpr std::size_t shifting_containers = BookList::stores_array + BookList::stores_vector;
+
+  // The number of linked lists, which walk to an offset to reach it.
+  constexpr std::size_t walking_containers = BookList::stores_sl_list + BookList::stores_dl_list;
+
+  // Returns the position `offset` books from the top of a container holding
+  // `size` books. Containers that can step backwards are walked from
+  // whichever end is nearer, so a doubly-linked list reaches its bottom as
+  // cheaply as its top; the forward_list always walks from the top.
+  template <typename Iterator>
+  Iterator step_to(Iterator begin, Iterator end, std::size_t size, std::size_t offset) {
+    using category = typename std::iterator_traits<Iterator>::iterator_category;
+    if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag, category>) {
+      if (offset > size / 2) {
+        return std::prev(end, static_cast<std::ptrdiff_t>(size - offset));
+      }
+    }
+    return std::next(begin, static_cast<std::ptrdiff_t>(offset));
+  }
+
+  // Returns how many books the stored linked lists step over to reach
+  // `offset` in a list of `size` books, as step_to() walks them.
+  constexpr std::size_t list_steps(std::size_t offset, std::size_t size) noexcept {
+    return BookList::stores_sl_list * offset
+        + BookList::stores_dl_list * std::min(offset, size - offset);
+  }
+
+#if BOOK_LIST_INSTRUMENTATION
+  // The statistics of one operation, updated from any thread.
+  struct SharedCallStats {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> elements_scanned{0};
+    std::atomic<std::uint64_t> books_copied{0};
+    std::atomic<std::uint64_t> books_shifted{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+  };
+
+  std::array<SharedCallStats, BookList::operation_count> shared_stats;
+
+  std::atomic<BookList::StatsHook*> stats_hook{nullptr};
+
+  // Measures one call to an operation, from its construction to its
+  // destruction, then adds it to the shared statistics and reports it to the
+  // hook. The innermost call being measured on this thread collects the
+  // counts; when it ends it passes them on to the call that made it, so each
+  // call's counts include those of the calls it made.
+  //
+  // A call to an operation made while the same operation is already being
+  // measured, such as an insert() overload delegating to another, is part of
+  // that call rather than a call of its own.
+  class Measured {
+   public:
+    explicit Measured(BookList::Operation operation) noexcept
+        : operation_(operation), outer_(innermost_) {
+      if (outer_ != nullptr && outer_->operation_ == operation) {
+        return;
+      }
+      innermost_ = this;
+      started_ = std::chrono::steady_clock::now();
+    }
+
+    Measured(const Measured&) = delete;
+    Measured& operator=(const Measured&) = delete;
+
+    ~Measured() {
+      if (innermost_ != this) {
+        return;
+      }
+      innermost_ = outer_;
+
+      call_.calls = 1;
+      call_.nanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - started_).count());
+      if (outer_ != nullptr) {
+        outer_->call_.elements_scanned += call_.elements_scanned;
+        outer_->call_.books_copied += call_.books_copied;
+        outer_->call_.books_shifted += call_.books_shifted;
+      }
+
+      SharedCallStats& shared = shared_stats[static_cast<std::size_t>(operation_)];
+      shared.calls.fetch_add(1, std::memory_order_relaxed);
+      shared.elements_scanned.fetch_add(call_.elements_scanned, std::memory_order_relaxed);
+      shared.books_copied.fetch_add(call_.books_copied, std::memory_order_relaxed);
+      shared.books_shifted.fetch_add(call_.books_shifted, std::memory_order_relaxed);
+      shared.nanoseconds.fetch_add(call_.nanoseconds, std::memory_order_relaxed);
+
+      if (BookList::StatsHook* hook = stats_hook.load(std::memory_order_acquire)) {
+        hook->on_call(operation_, call_);
+      }
+    }
+
+    // Add to the counts of the innermost call being measured on this thread,
+    // if there is one.
+    static void scanned(std::size_t count) noexcept {
+      if (innermost_ != nullptr) {
+        innermost_->call_.elements_scanned += count;
+      }
+    }
+
+    static void copied(std::size_t count) noexcept {
+      if (innermost_ != nullptr) {
+        innermost_->call_.books_copied += count;
+      }
+    }
+
+    static void shifted(std::size_t count) noexcept {
+      if (innermost_ != nullptr) {
+        innermost_->call_.books_shifted += count;
+      }
+    }
+
+   private:
+    static thread_local Measured* innermost_;
+
+    BookList::Operation operation_;
+    Measured* outer_;
+    BookList::CallStats call_;
+    std::chrono::steady_clock::time_point started_;
+  };
+
+  thread_local Measured* Measured::innermost_ = nullptr;
+#else
+  // Without instrumentation nothing is measured, and these compile away.
+  class Measured {
+   public:
+    explicit Measured(BookList::Operation) noexcept {}
+
+    static void scanned(std::size_t) noexcept {}
+    static void copied(std::size_t) noexcept {}
+    static void shifted(std::size_t) noexcept {}
+  };
+#endif
+
+#if BOOK_LIST_VALIDATION_LEVEL == BOOK_LIST_VALIDATION_SAMPLED
+  // Counts the consistency checks made by this thread, so the sampled
+  // validation level knows when the next full sweep is due. Keeping the count
+  // per thread rather than per list keeps the const queries free of shared
+  // mutable state.
+  thread_local std::size_t consistency_checks_made = 0;
+#endif
+}
+
+BookList::primary_iterator BookList::primary_begin() const {
+#if BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_VECTOR
+  return books_vector_.cbegin();
+#elif BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_ARRAY
+  return books_array_.cbegin();
+#elif BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_CHUNKED
+  return books_chunks_.cbegin();
+#elif BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_DL_LIST
+  return books_dl_list_.cbegin();
+#else
+  return books_sl_list_.cbegin();
+#endif
+}
+
+BookList::primary_iterator BookList::primary_end() const {
+#if BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_VECTOR
+  return books_vector_.cend();
+#elif BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_ARRAY
+  return books_array_.cend();
+#elif BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_CHUNKED
+  return books_chunks_.cend();
+#elif BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_DL_LIST
+  return books_dl_list_.cend();
+#else
+  return books_sl_list_.cend();
+#endif
+}
+
 bool BookList::containers_are_consistent() const {
-  // If the sizes of the containers are not all equal, the containers are not
-  // consistent.
-  if (books_array_size_ != books_vector_.size()
-      || books_array_size_ != books_dl_list_.size()
-      || books_array_size_ !=  books_sl_list_size()) {
+  const Measured measured(Operation::consistency_check);
+#if BOOK_LIST_VALIDATION_LEVEL == BOOK_LIST_VALIDATION_OFF
+  return true;
+#elif BOOK_LIST_VALIDATION_LEVEL == BOOK_LIST_VALIDATION_SAMPLED
+  if (!container_sizes_are_consistent()) {
     return false;
   }
+  if (++consistency_checks_made % BOOK_LIST_VALIDATION_SAMPLE_PERIOD != 0) {
+    return true;
+  }
+  return container_contents_are_consistent();
+#elif BOOK_LIST_VALIDATION_LEVEL == BOOK_LIST_VALIDATION_DEFERRED
+  // The contents wait for validate().
+  return container_sizes_are_consistent();
+#else
+  return container_contents_are_consistent();
+#endif
+}
+
+bool BookList::container_sizes_are_consistent() const {
+  // Every stored container must hold size() books. The containers that are
+  // not stored must be empty.
+  const std::size_t expected = size_unchecked();
+#if BOOK_LIST_HASH_INDEX
+  if (books_index_.size() != expected) {
+    return false;
+  }
+#endif
+#if BOOK_LIST_ORDERED_INDEXES
+  if (author_index_.size() != expected || title_index_.size() != expected
+      || price_index_.size() != expected) {
+    return false;
+  }
+#endif
+  return books_array_.size() == (stores_array ? expected : 0)
+      && books_vector_.size() == (stores_vector ? expected : 0)
+      && books_dl_list_.size() == (stores_dl_list ? expected : 0)
+      && books_chunks_.size() == (stores_chunked ? expected : 0)
+      && books_sl_list_size_ == (stores_sl_list ? expected : 0);
+}
 
-  // Element content and order must be equal to each other
-  auto current_array_position = books_array_.cbegin();
-  auto current_vector_position = books_vector_.cbegin();
-  auto current_dl_list_position = books_dl_list_.cbegin();
-  auto current_sl_list_position = books_sl_list_.cbegin();
+bool BookList::container_contents_are_consistent() const {
+  // The whole list is the range, and the forward_list's own count of its
+  // books must match the one kept for it.
+  return books_sl_list_size_ == books_sl_list_size()
+      && container_range_is_consistent(0, unbounded_capacity);
+}
 
-  while (current_vector_position != books_vector_.cend()) {
-    if (*current_array_position != *current_vector_position
-        || *current_array_position != *current_dl_list_position
-        || *current_array_position != *current_sl_list_position) {
+bool BookList::container_range_is_consistent(std::size_t first, std::size_t last) const {
+  // If the sizes of the containers are not all equal, the containers are not
+  // consistent.
+  if (!container_sizes_are_consistent()) {
+    return false;
+  }
+  const std::size_t count = size_unchecked();
+  last = std::min(last, count);
+  first = std::min(first, last);
+
+  // Element content and order must be equal to each other. Each stored
+  // container is compared against the primary one, from `first` on. The
+  // containers not stored are empty, so they stay at their beginning.
+  Measured::scanned(walking_containers * first);
+  auto current_array_position = std::next(books_array_.cbegin(), stores_array ? first : 0);
+  auto current_vector_position = std::next(books_vector_.cbegin(), stores_vector ? first : 0);
+  auto current_dl_list_position = std::next(books_dl_list_.cbegin(), stores_dl_list ? first : 0);
+  auto current_sl_list_position = std::next(books_sl_list_.cbegin(), stores_sl_list ? first : 0);
+  auto current_chunked_position = std::next(books_chunks_.cbegin(), stores_chunked ? first : 0);
+
+  auto current_position = std::next(primary_begin(), first);
+  for (std::size_t offset = first; offset != last; ++offset, ++current_position) {
+    Measured::scanned(stored_containers);
+    if ((stores_array && *current_array_position != *current_position)
+        || (stores_vector && *current_vector_position != *current_position)
+        || (stores_dl_list && *current_dl_list_position != *current_position)
+        || (stores_sl_list && *current_sl_list_position != *current_position)
+        || (stores_chunked && *current_chunked_position != *current_position)) {
       return false;
     }
 
-    // Advance the iterators to the next element in unison
-    ++current_array_position;
-    ++current_vector_position;
-    ++current_dl_list_position;
-    ++current_sl_list_position;
+    // Advance the iterators of the stored containers in unison
+    if (stores_array) ++current_array_position;
+    if (stores_vector) ++current_vector_position;
+    if (stores_dl_list) ++current_dl_list_position;
+    if (stores_sl_list) ++current_sl_list_position;
+    if (stores_chunked) ++current_chunked_position;
   }
 
-  return true;
+  // A range reaching the bottom also shows whether the forward_list ends
+  // where its kept count says it does.
+  return last != count || !stores_sl_list || current_sl_list_position == books_sl_list_.cend();
 }
 
 std::size_t BookList::books_sl_list_size() const {
@@ -61,29 +469,104 @@ std::size_t BookList::books_sl_list_size() const {
     // list, so therefore the size. 
 
     // returns the singly-linked list size
+    Measured::scanned(books_sl_list_size_);
     return std::distance(books_sl_list_.begin(), books_sl_list_.end());
 }
 
+void BookList::reindex_from(std::size_t offset_from_top, std::size_t end_offset) {
+  // An index of membership alone holds no offsets to renumber.
+  if (BOOK_LIST_HASH_INDEX != 1) {
+    return;
+  }
+  const std::size_t count = std::min(end_offset, size_unchecked());
+  if (offset_from_top >= count) {
+    return;
+  }
+  Measured::scanned(count - offset_from_top);
+  auto position = std::next(primary_begin(), offset_from_top);
+  for (std::size_t offset = offset_from_top; offset < count; ++offset, ++position) {
+    books_index_[*position] = offset;
+  }
+}
+
+void BookList::mark_changed(std::size_t first, std::size_t last) noexcept {
+  changed_first_ = std::min(changed_first_, first);
+  changed_last_ = std::max(changed_last_, last);
+}
+
+void BookList::index_book(std::size_t offset) {
+  Measured::scanned(author_index_.size() + title_index_.size() + price_index_.size());
+  const Book& book = *std::next(primary_begin(), offset);
+  add_entry(author_index_, &book.author(), offset);
+  add_entry(title_index_, &book.title(), offset);
+  add_entry(price_index_, book.price(), offset);
+}
+
+void BookList::unindex_book(std::size_t offset) {
+  Measured::scanned(author_index_.size() + title_index_.size() + price_index_.size());
+  const Book& book = *std::next(primary_begin(), offset);
+  remove_entry(author_index_, &book.author(), offset);
+  remove_entry(title_index_, &book.title(), offset);
+  remove_entry(price_index_, book.price(), offset);
+}
+
 //
 // Constructors, Assignments, and Destructor
 //
 
 BookList::BookList() = default;
 
+BookList::BookList(std::size_t capacity) : books_array_(capacity) {}
+
+BookList::BookList(std::size_t capacity, std::pmr::memory_resource* resource)
+    : books_array_(capacity, resource),
+      books_vector_(resource),
+      books_sl_list_(resource),
+      books_dl_list_(resource),
+      books_chunks_(resource),
+      books_index_(resource),
+      author_index_(resource),
+      title_index_(resource),
+      price_index_(resource) {}
+
 BookList::BookList(const BookList& other) = default;
 
-BookList::BookList(BookList&& other) = default;
+BookList::BookList(const BookList& other, std::pmr::memory_resource* resource)
+    : BookList(other.books_array_.capacity(), resource) {
+  *this = other;
+}
+
+// Moving swaps with an empty list rather than moving member by member, so
+// the moved-from list is left empty and consistent instead of keeping a stale
+// forward_list size.
+BookList::BookList(BookList&& other)
+    : BookList(default_capacity, other.get_allocator().resource()) {
+  swap(other);
+}
 
+// The std::pmr containers keep their own resource on assignment, copying the
+// books over from another one.
 BookList& BookList::operator=(const BookList& rhs) = default;
 
-BookList& BookList::operator=(BookList&& rhs) = default;
+BookList& BookList::operator=(BookList&& rhs) {
+  if (this == &rhs) {
+    return *this;
+  }
+
+  if (get_allocator() == rhs.get_allocator()) {
+    BookList moved(std::move(rhs));
+    swap(moved);
+  } else {
+    // Only lists with the same resource can swap their containers.
+    *this = rhs;
+  }
+  return *this;
+}
 
 BookList::~BookList() = default;
 
 BookList::BookList(const std::initializer_list<Book>& init_list) {
-  for (const Book& book : init_list) {
-    insert(book, Position::BOTTOM);
-  }
+  append(init_list.begin(), init_list.end());
 
   // Verify the internal book list state is still consistent amongst the four
   // containers.
@@ -95,21 +578,12 @@ BookList::BookList(const std::initializer_list<Book>& init_list) {
 
 BookList& BookList::operator+=(const std::initializer_list<Book>& rhs) {
     // Concatenate the right hand side book list of books to this list by
-    // repeatedly inserting at the bottom of this book list.
+    // appending them all to the bottom of this book list in one batch.
     //
     // The input type is a container of books accessible with iterators like
-    // all the other containers. The constructor above gives an example. Use
-    // BookList::insert() to insert at the bottom.
-
-    // used a range based for loop to create the variable book that will be used to 
-    // iterate over rhs list elements
-
-    for (const Book& book : rhs) {
-      // we insert each element, book, at the bottom of BookListand this repeats
-      insert(book, Position::BOTTOM);
-    }
-    
-
+    // all the other containers, so its range can be handed to
+    // BookList::append() directly.
+    append(rhs.begin(), rhs.end());
 
   // Verify the internal book list state is still consistent amongst the four containers.
   if (!containers_are_consistent()) {
@@ -121,24 +595,14 @@ BookList& BookList::operator+=(const std::initializer_list<Book>& rhs) {
 
 BookList& BookList::operator+=(const BookList& rhs) {
     // Concatenate the right hand side book list of books to this list by
-    // repeatedly inserting at the bottom of this book list.
+    // appending them all to the bottom of this book list in one batch.
     //
     // All the rhs containers (array, vector, list, and forward_list) contain
-    // the same information, so pick just one to traverse. Walk the container 
-    // you picked, inserting its books to the bottom of this book list. Use
-    // BookList::insert() to insert at the bottom.
-    
-    // Uses a range based for loop and the rhs container, vector,
-    // to concatenate the rhs book list.
-
-    // Each time the loop iterates, a book from rhs.books_vector_ is assigned to book.
-    for (const Book& book : rhs.books_vector_) {
-      // While the for loop executes, uses BookList::insert() to insert book to the 
-      // bottom of the book list
-      insert(book, Position::BOTTOM);
-    }
-    
-
+    // the same information, so the rhs primary container (the vector unless
+    // BOOK_LIST_STORAGE leaves it out) is the one handed to BookList::append().
+    // append() copies the books before changing anything, so appending a
+    // list to itself is safe.
+    append(rhs.primary_begin(), rhs.primary_end());
 
   // Verify the internal book list state is still consistent amongst the four
   // containers.
@@ -154,6 +618,7 @@ BookList& BookList::operator+=(const BookList& rhs) {
 //
 
 std::size_t BookList::size() const {
+  const Measured measured(Operation::size);
   // Verify the internal book list state is still consistent amongst the four
   // containers.
   if (!containers_are_consistent()) {
@@ -170,11 +635,41 @@ std::size_t BookList::size() const {
     // Since std::vector has a size() function, its convenient to use it to return
     // the size of the vector container. 
 
-    // Returns the size of the vector container.  
-    return  books_vector_.size();
+    // Returns the size of the vector container, or of whichever container
+    // holds the books when BOOK_LIST_STORAGE leaves the vector out.
+    return size_unchecked();
+}
+
+bool BookList::empty() const {
+  return size() == 0;
+}
+
+std::size_t BookList::capacity() const {
+  return stores_array ? books_array_.capacity() : unbounded_capacity;
+}
+
+BookList::allocator_type BookList::get_allocator() const noexcept {
+  return books_array_.get_allocator();
+}
+
+std::size_t BookList::size_unchecked() const {
+  if (stores_vector) {
+    return books_vector_.size();
+  }
+  if (stores_array) {
+    return books_array_.size();
+  }
+  if (stores_chunked) {
+    return books_chunks_.size();
+  }
+  if (stores_dl_list) {
+    return books_dl_list_.size();
+  }
+  return books_sl_list_size_;
 }
 
 std::size_t BookList::find(const Book& book) const {
+  const Measured measured(Operation::find);
   // Verify the internal book list state is still consistent amongst the four
   // containers.
   if (!containers_are_consistent()) {
@@ -191,20 +686,193 @@ std::size_t BookList::find(const Book& book) const {
     // search. The STL provides the find() function that is a perfect fit here,
     // but you may also write your own loop.
 
-    std::vector<Book>::const_iterator iter = std::find(books_vector_.begin(), books_vector_.end(), book);
-    if (iter != books_vector_.end()) {
+#if BOOK_LIST_HASH_INDEX == 1
+    // The index already knows the offset of every book in the list.
+    auto indexed = books_index_.find(book);
+    return indexed != books_index_.end() ? indexed->second : size();
+#else
+#  if BOOK_LIST_HASH_INDEX
+    // The index knows which books are in the list, which settles a miss
+    // without scanning.
+    if (books_index_.count(book) == 0) {
+      return size_unchecked();
+    }
+#  endif
+    if constexpr (primary_is_contiguous) {
+      // The vector and the array can be split between threads when large.
+      const primary_iterator books = primary_begin();
+      const std::size_t offset = find_first(size_unchecked(), [&](std::size_t offset) { return book_at(books, offset) == book; });
+      Measured::scanned(std::min(offset + 1, size_unchecked()));
+      return offset;
+    }
+
+    primary_iterator iter = std::find(primary_begin(), primary_end(), book);
+    Measured::scanned(std::min<std::size_t>(std::distance(primary_begin(), iter) + 1, size_unchecked()));
+    if (iter != primary_end()) {
       // iter is now pointing at the right object
       // vector.begin() returns an iterator pointing to the first vector element
       // To get the number of positions traveled
       // I would find the difference between the two iterators
       // in the case of zero-based positions
       // the distance from the beginning is the correct position
-      return iter - books_vector_.begin(); 
+      return std::distance(primary_begin(), iter);
     } else {
-      // iter == books_vector_.end(), this means that book was not found.
+      // iter == primary_end(), this means that book was not found.
       // Since book was not found, the size of this book list is returned. 
       return size();
     }
+#endif
+}
+
+const Book& BookList::at(std::size_t offset_from_top) const {
+  const Measured measured(Operation::at);
+  if (offset_from_top >= size()) {
+    throw InvalidOffsetException("Offset beyond end of current list size in at");
+  }
+  Measured::scanned(primary_is_contiguous || stores_chunked ? 1
+                    : (stores_dl_list ? std::min(offset_from_top, size_unchecked() - offset_from_top - 1)
+                                      : offset_from_top) + 1);
+  return *step_to(primary_begin(), primary_end(), size_unchecked(), offset_from_top);
+}
+
+const Book& BookList::operator[](std::size_t offset_from_top) const {
+  return *step_to(primary_begin(), primary_end(), size_unchecked(), offset_from_top);
+}
+
+BookList::const_iterator BookList::begin() const {
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in begin");
+  }
+  return primary_begin();
+}
+
+BookList::const_iterator BookList::end() const {
+  return primary_end();
+}
+
+BookList::const_iterator BookList::cbegin() const {
+  return begin();
+}
+
+BookList::const_iterator BookList::cend() const {
+  return end();
+}
+
+std::vector<std::size_t> BookList::find_by_author(std::string_view author) const {
+  const Measured measured(Operation::find_by_author);
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in find_by_author");
+  }
+
+#if BOOK_LIST_ORDERED_INDEXES
+  std::vector<std::size_t> offsets = offsets_between(author_index_, author, author);
+  Measured::scanned(offsets.size());
+  return offsets;
+#else
+  Measured::scanned(size_unchecked());
+  std::vector<std::size_t> offsets;
+  std::size_t offset = 0;
+  for (auto position = primary_begin(); position != primary_end(); ++position, ++offset) {
+    if (position->author() == author) {
+      offsets.push_back(offset);
+    }
+  }
+  return offsets;
+#endif
+}
+
+std::vector<std::size_t> BookList::find_by_title(std::string_view title) const {
+  const Measured measured(Operation::find_by_title);
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in find_by_title");
+  }
+
+#if BOOK_LIST_ORDERED_INDEXES
+  std::vector<std::size_t> offsets = offsets_between(title_index_, title, title);
+  Measured::scanned(offsets.size());
+  return offsets;
+#else
+  Measured::scanned(size_unchecked());
+  std::vector<std::size_t> offsets;
+  std::size_t offset = 0;
+  for (auto position = primary_begin(); position != primary_end(); ++position, ++offset) {
+    if (position->title() == title) {
+      offsets.push_back(offset);
+    }
+  }
+  return offsets;
+#endif
+}
+
+std::vector<std::size_t> BookList::find_priced_between(double low, double high) const {
+  const Measured measured(Operation::find_priced_between);
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in find_priced_between");
+  }
+
+#if BOOK_LIST_ORDERED_INDEXES
+  std::vector<std::size_t> offsets = offsets_between(price_index_, low, high);
+  Measured::scanned(offsets.size());
+  return offsets;
+#else
+  Measured::scanned(size_unchecked());
+  std::vector<IndexEntry<double>> matches;
+  std::size_t offset = 0;
+  for (auto position = primary_begin(); position != primary_end(); ++position, ++offset) {
+    if (position->price() >= low && position->price() <= high) {
+      matches.push_back({position->price(), offset});
+    }
+  }
+  std::sort(matches.begin(), matches.end(), EntryLess());
+
+  std::vector<std::size_t> offsets;
+  offsets.reserve(matches.size());
+  for (const IndexEntry<double>& match : matches) {
+    offsets.push_back(match.offset);
+  }
+  return offsets;
+#endif
+}
+
+std::string& BookList::write_to(std::string& buffer) const {
+  write_to([&buffer](std::string_view chunk) { buffer += chunk; },
+           std::numeric_limits<std::size_t>::max());
+  return buffer;
+}
+
+void BookList::write_to(const std::function<void(std::string_view)>& sink,
+                        std::size_t chunk_size) const {
+  const Measured measured(Operation::write_to);
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in write_to");
+  }
+
+  // Mirrors operator<< below: the count, then each book on its own line
+  // after its row number right-aligned in five columns, then a newline.
+  std::string buffer;
+  buffer.reserve(std::min<std::size_t>(chunk_size, 64 * 1024) + 256);
+  append_number(buffer, size_unchecked());
+  Measured::scanned(size_unchecked());
+
+  std::size_t row = 0;
+  for (auto position = primary_begin(); position != primary_end(); ++position) {
+    buffer += '\n';
+    append_number(buffer, row++, 5);
+    buffer += ":  ";
+    position->write_to(buffer);
+
+    if (buffer.size() >= chunk_size) {
+      sink(buffer);
+      buffer.clear();
+    }
+  }
+  buffer += '\n';
+  sink(buffer);
 }
 
 //
@@ -226,9 +894,39 @@ BookList& BookList::insert(const Book& book, Position position) {
   return *this;
 }
 
+BookList& BookList::insert(Book&& book, Position position) {
+  switch (position) {
+    case Position::TOP: {
+      insert(std::move(book), 0);
+      break;
+    }
+    case Position::BOTTOM: {
+      insert(std::move(book), size());
+      break;
+    }
+  }
+  return *this;
+}
+
+BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
+  const Measured measured(Operation::insert);
+  // Reject bad offsets and duplicates before paying for the copy, then let the
+  // rvalue overload move the copy into place.
+  if (offset_from_top > size()) {
+    throw InvalidOffsetException(
+        "Insertion position beyond end of current list size in insert");
+  }
+  if (find(book) != size()) {
+    return *this;
+  }
+  Measured::copied(1);
+  return insert(Book(book), offset_from_top);
+}
+
 // Insert the new book at offset_from_top, which places it before the current
 // book at that position.
-BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
+BookList& BookList::insert(Book&& book, std::size_t offset_from_top) {
+  const Measured measured(Operation::insert);
   // Validate offset parameter before attempting the insertion. As std::size_t
   // is an unsigned type, there is no need to check for negative offsets. And an
   // offset equal to the size of the list says to insert at the end (bottom) of
@@ -269,65 +967,43 @@ BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
   // is the same. A check is made at the end of this function to verify the
   // contents of all four containers are indeed the same.
 
+  // Every container but the last receives a copy, the contiguous ones shift
+  // the books below the offset down, and the lists walk to it.
+  Measured::copied(stored_containers - 1);
+  Measured::shifted(shifting_containers * (size_unchecked() - offset_from_top));
+  Measured::scanned(list_steps(offset_from_top, size_unchecked()));
+
+  // Every book from the new one down has moved.
+  mark_changed(offset_from_top);
+
   //
   // Insert into array
   //
 
-  {
-      // Unlike the other containers, std::array has no insert() function, so
-      // you have to write it yourself. Insert into the array by shifting all
-      // the items at and after the insertion point (offset_from_top) to the
-      // right, opening a gap in the array that can be populated with the given
-      // book.
-      //
-      // Remember that arrays have fixed capacity and cannot grow, so make sure 
-      // there is room in the array for another book before you start by
-      // verifying books_array_size_ is less than books_array_.size(). If
-      // not, throw a CapacityExceededException exception.
-      //
-      // Also remember that you must keep track of the number of valid books in
-      // your array, so don't forget to adjust books_array_size_.
-      //
-
-      // To check that there is enough room in the array for another book, we checked
-      // if books_array_size_ is greater than or equal to books_array_.size() because 
-      // that means books_array_ is too small to hold another book if true. 
-      if (books_array_size_ >= books_array_.size()) {
-        throw CapacityExceededException("Capacity Exceeded. books_array_size_ is less thanbooks_array_.size()");
+  if (stores_array) {
+      // The array has a fixed capacity, chosen when the book list was
+      // constructed, so make sure there is room for another book before
+      // inserting. If not, throw a CapacityExceededException exception.
+      if (books_array_.full()) {
+        throw CapacityExceededException("Capacity Exceeded. books_array_ already holds capacity() books");
       }
 
-      // To add the book, first create a gap at the index where offset_from_top will be added.
-      // All the elements at the indexes that are less than offset_from_top will not be changed.
-      // All the elements at indexes greater than or equal to offset_from_top will be changed.
-
-      // int i in the for loop is initialized to books_array_size_ to represent the number of
-      // books that are in books_array_. 
-      // The loop iterates until int i (the index) is greater than offset_from_top. 
-      // Each time the loop iterates, i is decremented.
-      for (int i = books_array_size_; i > offset_from_top; --i) {
-        //  Starting from i = book_array_size_ ensures that all the elements to the right
-        //  of the gap are shifted one index to the right and copied.
-
-        // Each time the loop iterates, we take the element from the index that comes before 
-        // the current index and assign it to the current index. 
-
-        books_array_[i] = books_array_[i - 1];
-
-        // The loop stops incrementing when i is equal to offset_from_top
+      // BookArray::insert() shifts every book at and after offset_from_top
+      // one slot to the right, opening a gap that is populated with the given
+      // book. The books are moved rather than copied, so their strings are not
+      // reallocated.
+      if (receives_book_last(BOOK_LIST_STORAGE_ARRAY)) {
+        books_array_.insert(offset_from_top, std::move(book));
+      } else {
+        books_array_.insert(offset_from_top, book);
       }
-
-      // Inserts the new book to the books_array_ since the loop did not insert it. 
-      books_array_[offset_from_top] = book;
-
-      // Increment size to represent a new book added to the array. 
-      books_array_size_++;
   }
 
   //
   // Insert into vector
   //
 
-  {
+  if (stores_vector) {
       // The vector STL container std::vector has an insert function, which can
       // be directly used here. But that function takes an iterator that points
       // to the book to insert before. You need to convert the zero-based
@@ -341,13 +1017,17 @@ BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
       // did for the array above.
 
       // Creates an iterator pointing to the beginning of books_vector_.
-      std::vector<Book>::iterator v_iter = books_vector_.begin();
+      std::pmr::vector<Book>::iterator v_iter = books_vector_.begin();
 
       // Mutates the iterator by advancing v_iter offset_from_top many times.
       v_iter = std::next(v_iter, offset_from_top);
 
       // book is inserted to the vector.
-      books_vector_.insert(v_iter, book);
+      if (receives_book_last(BOOK_LIST_STORAGE_VECTOR)) {
+        books_vector_.insert(v_iter, std::move(book));
+      } else {
+        books_vector_.insert(v_iter, book);
+      }
 
   }
 
@@ -355,7 +1035,7 @@ BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
   // Insert into singly-linked list
   //
 
-  {
+  if (stores_sl_list) {
       // The singly-linked list STL container std::forward_list has an insert
       // function, which can be directly used here. But that function inserts
       // AFTER the book pointed to, not before like the other containers. A
@@ -364,23 +1044,28 @@ BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
       // books_sl_list_.before_begin() offset_from_top many times. The STL has
       // a function called std::next() that does that, or you can write your own
       // loop.
-      // std::forward_list<Book> books_sl_list_;
+      // std::pmr::forward_list<Book> books_sl_list_;
 
       // Creates an iterator of type std::forward_list to point before the beginning of books_sl_list_.
-      std::forward_list<Book>::iterator sl_iter = books_sl_list_.before_begin();
+      std::pmr::forward_list<Book>::iterator sl_iter = books_sl_list_.before_begin();
 
       // Mutates sl_iter by advancing sl_iter offset_from_top many times. 
       sl_iter = std::next(sl_iter, offset_from_top);
 
       // Uses std::forward_list::insert_after() to insert book after sl_iter. 
-      books_sl_list_.insert_after(sl_iter, book);
+      if (receives_book_last(BOOK_LIST_STORAGE_SL_LIST)) {
+        books_sl_list_.insert_after(sl_iter, std::move(book));
+      } else {
+        books_sl_list_.insert_after(sl_iter, book);
+      }
+      ++books_sl_list_size_;
   }
 
   //
   // Insert into doubly-linked list
   //
 
-  {
+  if (stores_dl_list) {
       // The doubly-linked list STL container std::list has an insert function,
       // which can be directly used here. But that function takes an iterator
       // that points to the book to insert before. You need to convert the
@@ -388,16 +1073,51 @@ BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
       // books_dl_list_.begin() offset_from_top times. The STL has a function
       // called std::next() that does that, or you can write your own loop.
       
-      // Creates an iterator of type std::list to point to the beginning of books_dl_list_
-      std::list<Book>::iterator dl_iter = books_dl_list_.begin();
+      // Creates an iterator of type std::list that points offset_from_top
+      // books down books_dl_list_, walking from whichever end is nearer.
+      std::pmr::list<Book>::iterator dl_iter =
+          step_to(books_dl_list_.begin(), books_dl_list_.end(), books_dl_list_.size(), offset_from_top);
+
+      // Uses std::list::insert() to insert book before dl_iter. Unless the
+      // chunked container is stored too, this is the last container to
+      // receive the book, so it takes the original.
+      if (receives_book_last(BOOK_LIST_STORAGE_DL_LIST)) {
+        books_dl_list_.insert(dl_iter, std::move(book));
+      } else {
+        books_dl_list_.insert(dl_iter, book);
+      }
+  }
 
-      // Mutates dl_iter by advancing dl_iter offset_from_top many times. 
-      dl_iter = std::next(dl_iter, offset_from_top);
+  //
+  // Insert into chunked container
+  //
 
-      // Uses std::list::insert() to insert book before dl_iter
-      books_dl_list_.insert(dl_iter, book);
+  if (stores_chunked) {
+      // BookChunks::insert() finds the chunk holding the offset and shifts
+      // only the books after it in that chunk. It is always the last
+      // container to receive the book, so it takes the original.
+      books_chunks_.insert(offset_from_top, std::move(book));
   }
 
+#if BOOK_LIST_HASH_INDEX
+  //
+  // Insert into hash index
+  //
+
+  {
+      // The book itself may have been moved into a container by now, so index
+      // the copy held by the primary container. Every book below the new one
+      // moved down by one.
+      books_index_.emplace(*step_to(primary_begin(), primary_end(), size_unchecked(), offset_from_top),
+                           offset_from_top);
+      reindex_from(offset_from_top + 1);
+  }
+#endif
+
+#if BOOK_LIST_ORDERED_INDEXES
+  index_book(offset_from_top);
+#endif
+
   // Verify the internal book list state is still consistent amongst the four
   // containers.
   if (!containers_are_consistent()) {
@@ -407,12 +1127,180 @@ BookList& BookList::insert(const Book& book, std::size_t offset_from_top) {
   return *this;
 }
 
+BookList& BookList::insert_books(std::size_t offset_from_top, std::vector<Book>&& books) {
+  const Measured measured(Operation::insert_range);
+  if (offset_from_top > size()) {
+    throw InvalidOffsetException(
+        "Insertion position beyond end of current list size in insert_range");
+  }
+
+  //
+  // Discard duplicates in one pass
+  //
+
+  // Keep the first copy of each book not already in the list. The set refers
+  // to the kept books in place; reserving up front means `unique` never
+  // reallocates, so those references stay valid. Without the hash index the
+  // set also refers to the books already in the list, so each book is looked
+  // up in constant time either way.
+  std::vector<Book> unique;
+  unique.reserve(books.size());
+  {
+      std::unordered_set<std::reference_wrapper<const Book>, std::hash<Book>, std::equal_to<Book>> seen;
+#if !BOOK_LIST_HASH_INDEX
+      seen.reserve(size_unchecked() + books.size());
+      seen.insert(primary_begin(), primary_end());
+#else
+      seen.reserve(books.size());
+#endif
+      for (Book& book : books) {
+#if BOOK_LIST_HASH_INDEX
+        if (books_index_.count(book) != 0) {
+          continue;
+        }
+#endif
+        if (seen.find(book) == seen.end()) {
+          unique.push_back(std::move(book));
+          seen.insert(unique.back());
+        }
+      }
+  }
+
+  const std::size_t count = unique.size();
+  if (count == 0) {
+    return *this;
+  }
+
+  // Check the capacity before changing anything, so a batch that does not
+  // fit is rejected as a whole.
+  if (stores_array && count > books_array_.capacity() - books_array_.size()) {
+    throw CapacityExceededException("Capacity Exceeded. insert_range would exceed capacity()");
+  }
+
+  // The books were copied out of the range, and every container but the last
+  // copies them again. The contiguous containers shift the books below the
+  // offset once for the whole batch, and the lists walk to it.
+  Measured::copied(stored_containers * count);
+  Measured::shifted(shifting_containers * (size_unchecked() - offset_from_top));
+  Measured::scanned(list_steps(offset_from_top, size_unchecked()));
+  mark_changed(offset_from_top);
+
+  //
+  // Insert into each container once
+  //
+
+  if (stores_array) {
+      // Append the batch at the bottom, then rotate it up into place.
+      books_array_.reserve(books_array_.size() + count);
+      const std::size_t old_size = books_array_.size();
+      for (Book& book : unique) {
+        if (receives_book_last(BOOK_LIST_STORAGE_ARRAY)) {
+          books_array_.insert(books_array_.size(), std::move(book));
+        } else {
+          books_array_.insert(books_array_.size(), book);
+        }
+      }
+      std::rotate(books_array_.begin() + offset_from_top,
+                  books_array_.begin() + old_size,
+                  books_array_.end());
+  }
+
+  if (stores_vector) {
+      books_vector_.reserve(books_vector_.size() + count);
+      const auto position = std::next(books_vector_.begin(), offset_from_top);
+      if (receives_book_last(BOOK_LIST_STORAGE_VECTOR)) {
+        books_vector_.insert(position, std::make_move_iterator(unique.begin()),
+                             std::make_move_iterator(unique.end()));
+      } else {
+        books_vector_.insert(position, unique.begin(), unique.end());
+      }
+  }
+
+  if (stores_sl_list) {
+      const auto position = std::next(books_sl_list_.before_begin(), offset_from_top);
+      if (receives_book_last(BOOK_LIST_STORAGE_SL_LIST)) {
+        books_sl_list_.insert_after(position, std::make_move_iterator(unique.begin()),
+                                    std::make_move_iterator(unique.end()));
+      } else {
+        books_sl_list_.insert_after(position, unique.begin(), unique.end());
+      }
+      books_sl_list_size_ += count;
+  }
+
+  if (stores_dl_list) {
+      const auto position =
+          step_to(books_dl_list_.begin(), books_dl_list_.end(), books_dl_list_.size(), offset_from_top);
+      if (receives_book_last(BOOK_LIST_STORAGE_DL_LIST)) {
+        books_dl_list_.insert(position, std::make_move_iterator(unique.begin()),
+                              std::make_move_iterator(unique.end()));
+      } else {
+        books_dl_list_.insert(position, unique.begin(), unique.end());
+      }
+  }
+
+  if (stores_chunked) {
+      // Each book lands just below the one before it, in the chunk the last
+      // insert left the cursor on.
+      std::size_t offset = offset_from_top;
+      for (Book& book : unique) {
+        books_chunks_.insert(offset++, std::move(book));
+      }
+  }
+
+#if BOOK_LIST_HASH_INDEX
+  {
+      // Index the new books from the primary container, since `unique` has
+      // been moved from, then renumber the books below them.
+      books_index_.reserve(books_index_.size() + count);
+      auto position = std::next(primary_begin(), offset_from_top);
+      for (std::size_t offset = offset_from_top; offset < offset_from_top + count; ++offset, ++position) {
+        books_index_.emplace(*position, offset);
+      }
+      reindex_from(offset_from_top + count);
+  }
+#endif
+
+#if BOOK_LIST_ORDERED_INDEXES
+  // Moving the entries below the batch down by its size keeps them ordered,
+  // so the batch's own entries are sorted on their own and merged in, rather
+  // than sorting the whole index afresh for every batch appended.
+  const auto merge_batch = [&](auto& index, const auto& key_of) {
+    for (auto& entry : index) {
+      if (entry.offset >= offset_from_top) {
+        entry.offset += count;
+      }
+    }
+    const auto middle = static_cast<std::ptrdiff_t>(index.size());
+    auto position = std::next(primary_begin(), offset_from_top);
+    for (std::size_t offset = offset_from_top; offset < offset_from_top + count; ++offset, ++position) {
+      index.push_back({key_of(*position), offset});
+    }
+    std::sort(std::next(index.begin(), middle), index.end(), EntryLess());
+    std::inplace_merge(index.begin(), std::next(index.begin(), middle), index.end(), EntryLess());
+    Measured::scanned(index.size());
+  };
+  merge_batch(author_index_, [](const Book& book) { return &book.author(); });
+  merge_batch(title_index_, [](const Book& book) { return &book.title(); });
+  merge_batch(price_index_, [](const Book& book) { return book.price(); });
+#endif
+
+  // Verify the internal book list state is still consistent amongst the four
+  // containers, once for the whole batch.
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in insert_range");
+  }
+  return *this;
+}
+
 BookList& BookList::remove(const Book& book) {
+  const Measured measured(Operation::remove);
   remove(find(book));
   return *this;
 }
 
 BookList& BookList::remove(std::size_t offset_from_top) {
+  const Measured measured(Operation::remove);
   // Removing from the book list means you remove the book from each of the
   // containers (array, vector, list, and forward_list).
   //
@@ -427,62 +1315,44 @@ BookList& BookList::remove(std::size_t offset_from_top) {
     return *this;
   }
 
+  // The contiguous containers shift the books below the offset up, and the
+  // lists walk to it.
+  Measured::shifted(shifting_containers * (size_unchecked() - offset_from_top - 1));
+  Measured::scanned(list_steps(offset_from_top, size_unchecked()));
+  mark_changed(offset_from_top);
+
+#if BOOK_LIST_HASH_INDEX
   //
-  // Remove from array
+  // Remove from hash index
   //
 
   {
-      // Close the hole created by shifting to the left everything at and after
-      // the remove point.
-      //
-      // std::move() will be helpful, or write your own loop.  Also remember
-      // that you must keep track of the number of valid books in your array,
-      // so don't forget to adjust books_array_size_.
-      //
-
-      // there are 3 arguments for std::move(), each is an iterator 
-      
-      // The first two arguments are responsible for creating a range of elements 
-      // that we want to move 
-
-      // The third argument is the location or position where we want to begin moving 
-      // the elements from the range into. 
-
-      // Creates an iterator pointing to offset_from_top + 1 positions away from the beginning
-      // of the array. This iterator represents the beginning of the range of elements we want 
-      // to move. 
-
-      // The range starts at this position because we don't want to move anything to the left of
-      // offset_from_top, and we don't want to include the element at offset_from_top because
-      // we want to remove it from the array. So we start the range of the elements at one 
-      // position after offset_from_top because that's the first element we want to include. 
-      auto range_start_iter = books_array_.begin() + offset_from_top + 1;
-
-      // Creates an iterator pointing to the end of books_array_. This represents the end of 
-      // the range of elements we want to move. 
-
-      auto range_end_iter = books_array_.end();
-
-      // Creates an iter that points to the location where we starting moving the elements to.  
-      // Since we want to keep the elements that are left of offset_from_top and we want to remove
-      // the element at offset_from_top, we start iterating at offset_from_top positions from
-      // the beginning of the books_array_.
+      // Forget the book while the primary container still holds it. The books
+      // below it are renumbered once the hole has been closed.
+      books_index_.erase(*step_to(primary_begin(), primary_end(), size_unchecked(), offset_from_top));
+  }
+#endif
 
-      auto first_destination = books_array_.begin() + offset_from_top;
+#if BOOK_LIST_ORDERED_INDEXES
+  unindex_book(offset_from_top);
+#endif
 
-      // Uses std::move() to move the range of elements into first_destination. 
-      std::move(range_start_iter, range_end_iter, first_destination);
+  //
+  // Remove from array
+  //
 
-      // Decrement books_array_size_ to represent removing a book from the array
-      books_array_size_--;
-    
+  if (stores_array) {
+      // BookArray::erase() closes the hole by moving everything after the
+      // remove point one slot to the left, then destroys the vacated last
+      // slot.
+      books_array_.erase(offset_from_top);
   }
 
   //
   // Remove from vector
   //
 
-  {
+  if (stores_vector) {
       // The vector STL container std::vector has an erase function, which can
       // be directly used here. But that function takes an iterator that points
       // to the book to be removed. You need to convert the zero-based offset
@@ -495,7 +1365,7 @@ BookList& BookList::remove(std::size_t offset_from_top) {
     
       // Creates an iterator of type std::vector<Book> that is initialized with a position that has
       // been advanced offset_from_top many times from the beginning of books_vector_ by using std::next().
-      std::vector<Book>::iterator vector_position = std::next(books_vector_.begin(), offset_from_top);
+      std::pmr::vector<Book>::iterator vector_position = std::next(books_vector_.begin(), offset_from_top);
 
       // Uses std::vector::erase() to remove the element that vector_position is pointing to. 
       books_vector_.erase(vector_position);
@@ -505,7 +1375,7 @@ BookList& BookList::remove(std::size_t offset_from_top) {
   // Remove from singly-linked list
   //
 
-  {
+  if (stores_sl_list) {
       // The singly-linked list STL container std::forward_list has an erase
       // function, which can be directly used here. But that function erases
       // AFTER the book pointed to, not the one pointed to like the other
@@ -517,17 +1387,18 @@ BookList& BookList::remove(std::size_t offset_from_top) {
 
       // Creates an iterator of type std::forward_list<Book> that is initialized with a position 
       // that has been advanced offset_from_top many times from before the beginning of books_sl_list_. 
-      std::forward_list<Book>::iterator sl_position_iter = std::next(books_sl_list_.before_begin(), offset_from_top);
+      std::pmr::forward_list<Book>::iterator sl_position_iter = std::next(books_sl_list_.before_begin(), offset_from_top);
 
       // Uses the std::forward_list::erase_after() function to remove the element after sl_position_iter. 
       books_sl_list_.erase_after(sl_position_iter);
+      --books_sl_list_size_;
   }
 
   //
   // Remove from doubly-linked list
   //
 
-  {
+  if (stores_dl_list) {
       // The doubly-linked list STL container std::list has an erase function,
       // which can be directly used here. But that function takes an iterator
       // that points to the book to remove. You need to convert the zero-based
@@ -536,15 +1407,28 @@ BookList& BookList::remove(std::size_t offset_from_top) {
       // that does that, or you can write your own loop.
     
       // Creates an iterator of type std::list<Book> that is initialized with a position 
-      // that has been advanced offset_from_top many times from the beginning of books_dl_list_ by
-      // using std::next().
-      std::list<Book>::iterator dl_position_iter = std::next(books_dl_list_.begin(), offset_from_top);
+      // offset_from_top books down books_dl_list_, walking from whichever end
+      // is nearer, so removing the bottom book is as cheap as the top one.
+      std::pmr::list<Book>::iterator dl_position_iter =
+          step_to(books_dl_list_.begin(), books_dl_list_.end(), books_dl_list_.size(), offset_from_top);
 
       // Uses std::list::erase() to remove the element that dl_position_iter is pointing to. 
       books_dl_list_.erase(dl_position_iter);
 
   }
 
+  //
+  // Remove from chunked container
+  //
+
+  if (stores_chunked) {
+      books_chunks_.erase(offset_from_top);
+  }
+
+#if BOOK_LIST_HASH_INDEX
+  reindex_from(offset_from_top);
+#endif
+
   // Verify the internal book list state is still consistent amongst the four
   // containers.
   if (!containers_are_consistent()) {
@@ -555,18 +1439,68 @@ BookList& BookList::remove(std::size_t offset_from_top) {
 }
 
 BookList& BookList::move_to_top(const Book& book) {
+  const Measured measured(Operation::move_to_top);
 
-    // If the book exists, then remove and reinsert it. Else do nothing.
+    // If the book exists, then move it from its current position to the top.
+    // Else do nothing.
     //
     // Use BookList::find() to determine if the book exists in this book list.
+    // The book is relinked or rotated into place in each container rather
+    // than removed and reinserted, so it is never copied, and nothing is
+    // allocated unless the chunked container has to split its first chunk.
+    const std::size_t offset_from_top = find(book);
 
     // When using BookList::find(), we know if a book does not exist when size() is returned.
-    // When the if statement does not return size(), that means that the book exists and we should move it to the top.
-    if (find(book) != size()) { // if book exists
-      // Remove the book by using BookList::remove().
-      remove(book);
-      // Insert the book to the top of BookList by using BookList::insert().
-      insert(book, 0);
+    // A book already at the top stays where it is.
+    if (offset_from_top != size() && offset_from_top != 0) {
+      // The contiguous containers shift the books above it down, and the
+      // lists walk to it.
+      Measured::shifted(shifting_containers * offset_from_top);
+      Measured::scanned(list_steps(offset_from_top, size_unchecked()));
+      mark_changed(0, offset_from_top + 1);
+
+#if BOOK_LIST_ORDERED_INDEXES
+      // The book leaves the indexes from its old offset and rejoins them at
+      // the top, which moves the books above it down by one.
+      unindex_book(offset_from_top);
+#endif
+
+      // The contiguous containers rotate the books above it down by one slot
+      // with a single std::rotate().
+      if (stores_array) {
+        std::rotate(books_array_.begin(),
+                    books_array_.begin() + offset_from_top,
+                    books_array_.begin() + offset_from_top + 1);
+      }
+      if (stores_vector) {
+        std::rotate(books_vector_.begin(),
+                    std::next(books_vector_.begin(), offset_from_top),
+                    std::next(books_vector_.begin(), offset_from_top + 1));
+      }
+
+      // The linked lists unlink the node and relink it at the front.
+      if (stores_sl_list) {
+        const auto before_book = std::next(books_sl_list_.before_begin(), offset_from_top);
+        books_sl_list_.splice_after(books_sl_list_.before_begin(), books_sl_list_, before_book);
+      }
+      if (stores_dl_list) {
+        books_dl_list_.splice(books_dl_list_.begin(), books_dl_list_,
+                              step_to(books_dl_list_.begin(), books_dl_list_.end(),
+                                      books_dl_list_.size(), offset_from_top));
+      }
+
+      // The chunked container moves it out of its chunk and into the first.
+      if (stores_chunked) {
+        books_chunks_.move_to_front(offset_from_top);
+      }
+
+#if BOOK_LIST_HASH_INDEX
+      // Only the books from the top down to the old position have moved.
+      reindex_from(0, offset_from_top + 1);
+#endif
+#if BOOK_LIST_ORDERED_INDEXES
+      index_book(0);
+#endif
     }
 
 
@@ -580,6 +1514,7 @@ BookList& BookList::move_to_top(const Book& book) {
 }
 
 void BookList::swap(BookList& rhs) noexcept {
+  const Measured measured(Operation::swap);
   if (this == &rhs) {
     return;
   }
@@ -588,8 +1523,53 @@ void BookList::swap(BookList& rhs) noexcept {
   books_vector_.swap(rhs.books_vector_);
   books_dl_list_.swap(rhs.books_dl_list_);
   books_sl_list_.swap(rhs.books_sl_list_);
+  books_chunks_.swap(rhs.books_chunks_);
+  books_index_.swap(rhs.books_index_);
+  author_index_.swap(rhs.author_index_);
+  title_index_.swap(rhs.title_index_);
+  price_index_.swap(rhs.price_index_);
+
+  std::swap(books_sl_list_size_, rhs.books_sl_list_size_);
+  std::swap(changed_first_, rhs.changed_first_);
+  std::swap(changed_last_, rhs.changed_last_);
+}
+
+void BookList::reserve(std::size_t count) {
+  if (stores_array) {
+    books_array_.reserve(count);
+  }
+  if (stores_vector) {
+    books_vector_.reserve(count);
+  }
 
-  std::swap(books_array_size_, rhs.books_array_size_);
+#if BOOK_LIST_HASH_INDEX
+  books_index_.reserve(count);
+#endif
+
+#if BOOK_LIST_ORDERED_INDEXES
+  author_index_.reserve(count);
+  title_index_.reserve(count);
+  price_index_.reserve(count);
+#endif
+}
+
+//
+// Validation
+//
+
+void BookList::validate() {
+  const Measured measured(Operation::consistency_check);
+  if (changed_first_ >= changed_last_) {
+    return;
+  }
+
+  // The range stays marked if it fails, so every later call reports it too.
+  if (!container_range_is_consistent(changed_first_, changed_last_)) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in validate");
+  }
+  changed_first_ = unbounded_capacity;
+  changed_last_ = 0;
 }
 
 //
@@ -604,7 +1584,8 @@ std::ostream& operator<<(std::ostream& stream, const BookList& book_list) {
 
   int count = 0;
   stream << book_list.size();
-  for (auto&& book : book_list.books_sl_list_) {
+  for (auto position = book_list.primary_begin(); position != book_list.primary_end(); ++position) {
+    const Book& book = *position;
     stream << '\n' << std::setw(5) << count++ << ":  " << book;
   }
   stream << '\n';
@@ -628,20 +1609,43 @@ std::istream& operator>>(std::istream& stream, BookList& book_list) {
     // discards the next character that is read 
     stream.ignore(1);
 
-    // The while loop makes sure that only books_sl_list_size number of books are extracted 
+    // The while loop makes sure that only count number of books are extracted 
     // to avoid extracting any extra books. 
-    while (count != book_list.books_sl_list_size()) {
-       // Creates a temporary book object so that the istream data can be extracted to it 
-      Book temp_book;
-      
-      // discards/ignores the next 4 characters
-      stream.ignore(4);
-
-      // reads the istream data to temp_book 
-      stream >> temp_book;
+    //
+    // The books are read in batches of as many as the list still lacks and
+    // appended a batch at a time, so loading a catalog indexes and walks to
+    // the bottom once per batch instead of once per book. Only a batch with
+    // duplicates leaves the list short, and then the next batch reads the
+    // rest, so exactly the same records are read as one at a time.
+    std::vector<Book> batch;
+    while (count != book_list.size()) {
+      const std::size_t missing = count > book_list.size() ? count - book_list.size() : 1;
+      batch.clear();
+      while (batch.size() != missing) {
+        // Creates a temporary book object so that the istream data can be extracted to it 
+        Book temp_book;
+
+        // discards/ignores the next 4 characters
+        stream.ignore(4);
+
+        // reads the istream data to temp_book
+        stream >> temp_book;
+
+        // Stop at the first record that cannot be read. Without this, a
+        // truncated or malformed stream, or one repeating a book so the list
+        // never reaches `count`, would loop here forever. The stream is left
+        // failed, so the caller can tell.
+        if (!stream) {
+          break;
+        }
+        batch.push_back(std::move(temp_book));
+      }
 
-      // insert temp_book into the booklist
-      book_list.insert(temp_book, BookList::Position::BOTTOM);
+      // append the batch to the bottom of the booklist
+      book_list.append(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+      if (!stream) {
+        break;
+      }
     }
     
   
@@ -654,6 +1658,7 @@ std::istream& operator>>(std::istream& stream, BookList& book_list) {
 //
 
 int BookList::compare(const BookList& other) const {
+  const Measured measured(Operation::compare);
   if (!containers_are_consistent() || !other.containers_are_consistent()) {
     throw BookList::InvalidInternalStateException(
         "Container consistency error in compare");
@@ -692,24 +1697,40 @@ int BookList::compare(const BookList& other) const {
     }
   }
 
-  // Creates a const iterator of type std::vector<Book> to point to the beginning of other's books_vector_. 
-  std::vector<Book>::const_iterator other_iter = other.books_vector_.begin();
+  // The vector and the array are compared a slice per thread when large.
+  if constexpr (primary_is_contiguous) {
+    const primary_iterator books = primary_begin();
+    const primary_iterator other_books = other.primary_begin();
+    const std::size_t offset = find_first(size_unchecked(), [&](std::size_t offset) {
+      return book_at(books, offset) != book_at(other_books, offset);
+    });
+    Measured::scanned(std::min(offset + 1, size_unchecked()));
+    if (offset == size_unchecked()) {
+      return 0;
+    }
+    return book_at(books, offset) < book_at(other_books, offset) ? -1 : 1;
+  }
+
+  // Creates a const iterator to point to the beginning of other's primary container
+  // (books_vector_ unless BOOK_LIST_STORAGE leaves it out).
+  primary_iterator other_iter = other.primary_begin();
 
-  // Uses a for loop to iterate through the books_vector_ of this BookList object and other's. 
+  // Uses a for loop to iterate through the primary containers of this BookList object and other's. 
 
-  // vector_iter is created by using auto and is initialized to point at the beginning of books_vector_. 
+  // vector_iter is created by using auto and is initialized to point at the beginning of the primary container. 
 
   // Each time the loop iterates, the iterators of this BookList and other mutate to point to the next
-  // position in the books_vector_.
-  for (auto vector_iter = books_vector_.begin(); 
-            vector_iter != books_vector_.end();
+  // position in the primary container.
+  for (auto vector_iter = primary_begin(); 
+            vector_iter != primary_end();
             vector_iter++) {
-    // The two conditionals compare the contents at corresponding positions
-    if (*vector_iter < *other_iter) { // return -1 if this BookList's book is less than other's book
-      return -1;
-    } 
-    if (*vector_iter > *other_iter) { // return 1 if this Booklist's book is more than the other's book
-      return 1;
+    // Equal books are the common case, and Book::operator!= settles most
+    // pairs from their cached hashes, so only books known to differ pay to be
+    // ordered.
+    Measured::scanned(1);
+    if (*vector_iter != *other_iter) {
+      // return -1 if this BookList's book is less than other's book, 1 if it is more
+      return *vector_iter < *other_iter ? -1 : 1;
     }
     // if neither condition is met we look at the next book 
     other_iter++;
@@ -720,6 +1741,362 @@ int BookList::compare(const BookList& other) const {
   
 }
 
+//
+// Reconciliation
+//
+
+BookList::Diff BookList::diff(const BookList& target) const {
+  const Measured measured(Operation::diff);
+  if (!containers_are_consistent() || !target.containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in diff");
+  }
+
+  // Look each book up in target, through its own index when that keeps
+  // offsets, and otherwise through one built here in a single pass.
+  const std::size_t target_size = target.size_unchecked();
+#if BOOK_LIST_HASH_INDEX == 1
+  const auto target_offset = [&target, target_size](const Book& book) {
+    const auto entry = target.books_index_.find(book);
+    return entry == target.books_index_.end() ? target_size : entry->second;
+  };
+#else
+  std::unordered_map<std::reference_wrapper<const Book>, std::size_t, std::hash<Book>, std::equal_to<Book>> offsets;
+  offsets.reserve(target_size);
+  {
+    std::size_t offset = 0;
+    for (auto book = target.primary_begin(); book != target.primary_end(); ++book) {
+      offsets.emplace(*book, offset++);
+    }
+  }
+  Measured::scanned(target_size);
+  const auto target_offset = [&offsets, target_size](const Book& book) {
+    const auto entry = offsets.find(book);
+    return entry == offsets.end() ? target_size : entry->second;
+  };
+#endif
+
+  // Walk this list, removing the books target lacks and noting where in
+  // target the others go, in this list's order. Lists that differ slightly
+  // mostly line up, so the book after the last one placed is tried before
+  // the index. Only a contiguous target can be repositioned after a lookup.
+  Diff script;
+  std::vector<std::size_t> shared;
+  shared.reserve(std::min(size_unchecked(), target_size));
+  std::vector<bool> in_source(target_size, false);
+  {
+    std::size_t offset = 0;
+    primary_iterator expected = target.primary_begin();
+    std::size_t expected_offset = 0;
+    for (auto book = primary_begin(); book != primary_end(); ++book, ++offset) {
+      std::size_t destination = target_size;
+      if (expected_offset != target_size && *expected == *book) {
+        destination = expected_offset;
+        ++expected;
+        ++expected_offset;
+      } else {
+        destination = target_offset(*book);
+        if (primary_is_contiguous && destination != target_size) {
+          expected_offset = destination + 1;
+          expected = std::next(target.primary_begin(), static_cast<std::ptrdiff_t>(expected_offset));
+        }
+      }
+      if (destination == target_size) {
+        script.push_back({Edit::Kind::REMOVE, *book, offset});
+      } else {
+        in_source[destination] = true;
+        shared.push_back(destination);
+      }
+    }
+  }
+  Measured::scanned(size_unchecked());
+
+  // The books that stay put are the longest increasing run of destinations,
+  // found by patience sorting: tails[l] is where in `shared` the lowest
+  // destination ending a run of l + 1 books is, and previous[] links each
+  // book to the one before it in its run.
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> tails;
+  std::vector<std::size_t> previous(shared.size(), none);
+  for (std::size_t position = 0; position < shared.size(); ++position) {
+    const auto tail = std::lower_bound(tails.begin(), tails.end(), shared[position],
+        [&shared](std::size_t lhs, std::size_t rhs) { return shared[lhs] < rhs; });
+    if (tail != tails.begin()) {
+      previous[position] = *std::prev(tail);
+    }
+    if (tail == tails.end()) {
+      tails.push_back(position);
+    } else {
+      *tail = position;
+    }
+  }
+  std::vector<bool> stays(target_size, false);
+  for (std::size_t position = tails.empty() ? none : tails.back(); position != none; position = previous[position]) {
+    stays[shared[position]] = true;
+  }
+
+  // Walk target, inserting the books this list lacks and moving the shared
+  // books that do not stay put.
+  {
+    std::size_t offset = 0;
+    for (auto book = target.primary_begin(); book != target.primary_end(); ++book, ++offset) {
+      if (!in_source[offset]) {
+        script.push_back({Edit::Kind::INSERT, *book, offset});
+      } else if (!stays[offset]) {
+        script.push_back({Edit::Kind::MOVE, *book, offset});
+      }
+    }
+  }
+  Measured::scanned(target_size);
+  Measured::copied(script.size());
+  return script;
+}
+
+BookList& BookList::apply(const Diff& diff) {
+  const Measured measured(Operation::apply);
+  if (diff.empty()) {
+    return *this;
+  }
+
+  //
+  // Lay out the result, changing nothing
+  //
+
+  // The books the script removes or moves are passed over as the list is
+  // walked, and the inserted ones must not be among the books that stay.
+  std::unordered_map<std::reference_wrapper<const Book>, const Edit*, std::hash<Book>, std::equal_to<Book>> displaced;
+  std::unordered_set<std::reference_wrapper<const Book>, std::hash<Book>, std::equal_to<Book>> inserted;
+  std::size_t removes = 0;
+  for (const Edit& edit : diff) {
+    const bool added = edit.kind == Edit::Kind::INSERT
+        ? inserted.insert(edit.book).second
+        : displaced.emplace(edit.book, &edit).second;
+    if (!added) {
+      throw InvalidDiffException("Edit script names a book twice in apply");
+    }
+    removes += edit.kind == Edit::Kind::REMOVE;
+  }
+  if (displaced.size() > size_unchecked()) {
+    throw InvalidDiffException("Edit script removes or moves a book not in the list in apply");
+  }
+
+  const std::size_t result_size = size_unchecked() - removes + inserted.size();
+  if (stores_array && result_size > books_array_.capacity()) {
+    throw CapacityExceededException("Capacity Exceeded. apply would exceed capacity()");
+  }
+
+  // Inserts and moves claim their offsets first.
+  std::vector<const Book*> placed(result_size, nullptr);
+  for (const Edit& edit : diff) {
+    if (edit.kind != Edit::Kind::REMOVE) {
+      if (edit.offset >= result_size || placed[edit.offset] != nullptr) {
+        throw InvalidDiffException("Edit script places a book at a taken or invalid offset in apply");
+      }
+      placed[edit.offset] = &edit.book;
+    }
+  }
+
+  // Then the books that stay put fill the rest, top down, keeping their
+  // order. `source` holds where each book of the result comes from in the
+  // list, or `none` for an inserted book, and `destination` where each book
+  // of the list goes, or `none` for a removed one.
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> source(result_size, none);
+  std::vector<std::size_t> destination(size_unchecked(), none);
+  {
+    std::size_t offset = 0;
+    std::size_t slot = 0;
+    std::size_t found = 0;
+    for (auto book = primary_begin(); book != primary_end(); ++book, ++offset) {
+      const auto edit = displaced.find(*book);
+      if (edit != displaced.end()) {
+        ++found;
+        if (edit->second->kind == Edit::Kind::REMOVE) {
+          continue;
+        }
+        destination[offset] = edit->second->offset;
+      } else {
+        while (slot < result_size && placed[slot] != nullptr) {
+          ++slot;
+        }
+        if (slot == result_size) {
+          throw InvalidDiffException("Edit script removes or moves a book not in the list in apply");
+        }
+        destination[offset] = slot++;
+      }
+      if (!inserted.empty() && inserted.count(*book) != 0) {
+        throw InvalidDiffException("Edit script inserts a book the list keeps in apply");
+      }
+      source[destination[offset]] = offset;
+    }
+    Measured::scanned(size_unchecked());
+    if (found != displaced.size()) {
+      throw InvalidDiffException("Edit script removes or moves a book not in the list in apply");
+    }
+  }
+
+  // The first offset whose book changes, for validate().
+  std::size_t first_changed = 0;
+  while (first_changed < result_size && source[first_changed] == first_changed) {
+    ++first_changed;
+  }
+  mark_changed(first_changed);
+
+  //
+  // Rearrange each container once
+  //
+
+  // Books are moved into their new places and list nodes relinked, so only
+  // the inserted books are copied and only their nodes allocated. The
+  // contiguous containers move every book once.
+  Measured::copied(stored_containers * inserted.size());
+  Measured::shifted(shifting_containers * result_size);
+  std::pmr::memory_resource* const resource = get_allocator().resource();
+
+  if (stores_array) {
+      BookArray reordered(books_array_.capacity(), resource);
+      reordered.reserve(result_size);
+      for (std::size_t slot = 0; slot < result_size; ++slot) {
+        if (source[slot] == none) {
+          reordered.insert(slot, *placed[slot]);
+        } else {
+          reordered.insert(slot, std::move(books_array_[source[slot]]));
+        }
+      }
+      books_array_.swap(reordered);
+  }
+
+  if (stores_vector) {
+      std::pmr::vector<Book> reordered(resource);
+      reordered.reserve(result_size);
+      for (std::size_t slot = 0; slot < result_size; ++slot) {
+        if (source[slot] == none) {
+          reordered.push_back(*placed[slot]);
+        } else {
+          reordered.push_back(std::move(books_vector_[source[slot]]));
+        }
+      }
+      books_vector_.swap(reordered);
+  }
+
+  if (stores_sl_list) {
+      // A forward_list node can only be unlinked from behind, so each is
+      // first taken off the front into a list of its own.
+      Measured::scanned(books_sl_list_size_);
+      std::vector<std::pmr::forward_list<Book>> nodes;
+      nodes.reserve(books_sl_list_size_);
+      while (!books_sl_list_.empty()) {
+        nodes.emplace_back(resource);
+        nodes.back().splice_after(nodes.back().before_begin(), books_sl_list_, books_sl_list_.before_begin());
+      }
+      auto last = books_sl_list_.before_begin();
+      for (std::size_t slot = 0; slot < result_size; ++slot) {
+        if (source[slot] == none) {
+          last = books_sl_list_.insert_after(last, *placed[slot]);
+        } else {
+          books_sl_list_.splice_after(last, nodes[source[slot]]);
+          ++last;
+        }
+      }
+      books_sl_list_size_ = result_size;
+  }
+
+  if (stores_dl_list) {
+      Measured::scanned(books_dl_list_.size());
+      std::vector<std::pmr::list<Book>::iterator> nodes;
+      nodes.reserve(books_dl_list_.size());
+      for (auto node = books_dl_list_.begin(); node != books_dl_list_.end(); ++node) {
+        nodes.push_back(node);
+      }
+      std::pmr::list<Book> reordered(resource);
+      for (std::size_t slot = 0; slot < result_size; ++slot) {
+        if (source[slot] == none) {
+          reordered.push_back(*placed[slot]);
+        } else {
+          reordered.splice(reordered.end(), books_dl_list_, nodes[source[slot]]);
+        }
+      }
+      books_dl_list_.swap(reordered);
+  }
+
+  if (stores_chunked) {
+      BookChunks reordered(resource);
+      for (std::size_t slot = 0; slot < result_size; ++slot) {
+        if (source[slot] == none) {
+          reordered.insert(slot, *placed[slot]);
+        } else {
+          reordered.insert(slot, std::move(books_chunks_[source[slot]]));
+        }
+      }
+      books_chunks_.swap(reordered);
+  }
+
+#if BOOK_LIST_HASH_INDEX
+  {
+      // Renumber the entries from their old offsets rather than looking each
+      // book up again. An index of membership alone only drops the removed
+      // books. Then add the inserted ones.
+#if BOOK_LIST_HASH_INDEX == 1
+      for (auto entry = books_index_.begin(); entry != books_index_.end();) {
+        if (destination[entry->second] == none) {
+          entry = books_index_.erase(entry);
+        } else {
+          entry->second = destination[entry->second];
+          ++entry;
+        }
+      }
+#endif
+      for (const Edit& edit : diff) {
+        if (edit.kind == Edit::Kind::REMOVE) {
+          books_index_.erase(edit.book);
+        } else if (edit.kind == Edit::Kind::INSERT) {
+          books_index_.emplace(edit.book, edit.offset);
+        }
+      }
+      Measured::scanned(books_index_.size());
+  }
+#endif
+
+#if BOOK_LIST_ORDERED_INDEXES
+  // The entries keep their keys, so renumbering them leaves them ordered
+  // except among books sharing a key, which are put back in offset order.
+  // The inserted books are sorted on their own and merged in.
+  const auto reindex = [&](auto& index, const auto& key_of) {
+    using Entry = typename std::decay_t<decltype(index)>::value_type;
+    for (Entry& entry : index) {
+      entry.offset = destination[entry.offset];
+    }
+    index.erase(std::remove_if(index.begin(), index.end(), [](const Entry& entry) { return entry.offset == none; }),
+                index.end());
+    for (auto run = index.begin(); run != index.end();) {
+      const auto run_end = std::find_if(run, index.end(), [&](const Entry& entry) { return entry.key != run->key; });
+      std::sort(run, run_end, [](const Entry& lhs, const Entry& rhs) { return lhs.offset < rhs.offset; });
+      run = run_end;
+    }
+    const auto middle = static_cast<std::ptrdiff_t>(index.size());
+    for (const Edit& edit : diff) {
+      if (edit.kind == Edit::Kind::INSERT) {
+        index.push_back({key_of(edit.book), edit.offset});
+      }
+    }
+    std::sort(std::next(index.begin(), middle), index.end(), EntryLess());
+    std::inplace_merge(index.begin(), std::next(index.begin(), middle), index.end(), EntryLess());
+    Measured::scanned(index.size());
+  };
+  reindex(author_index_, [](const Book& book) { return &book.author(); });
+  reindex(title_index_, [](const Book& book) { return &book.title(); });
+  reindex(price_index_, [](const Book& book) { return book.price(); });
+#endif
+
+  // Verify the internal book list state is still consistent amongst the four
+  // containers.
+  if (!containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in apply");
+  }
+  return *this;
+}
+
 bool operator==(const BookList& lhs, const BookList& rhs) {
   return lhs.compare(rhs) == 0;
 }
@@ -742,4 +2119,72 @@ bool operator>(const BookList& lhs, const BookList& rhs) {
 
 bool operator>=(const BookList& lhs, const BookList& rhs) {
   return lhs.compare(rhs) >= 0;
-}
\ No newline at end of file
+}
+
+//
+// Instrumentation
+//
+
+BookList::StatsHook::~StatsHook() = default;
+
+const BookList::CallStats& BookList::Stats::operator[](Operation operation) const noexcept {
+  return operations[static_cast<std::size_t>(operation)];
+}
+
+BookList::Stats BookList::stats() noexcept {
+  Stats stats;
+#if BOOK_LIST_INSTRUMENTATION
+  for (std::size_t operation = 0; operation != operation_count; ++operation) {
+    const SharedCallStats& shared = shared_stats[operation];
+    CallStats& call = stats.operations[operation];
+    call.calls = shared.calls.load(std::memory_order_relaxed);
+    call.elements_scanned = shared.elements_scanned.load(std::memory_order_relaxed);
+    call.books_copied = shared.books_copied.load(std::memory_order_relaxed);
+    call.books_shifted = shared.books_shifted.load(std::memory_order_relaxed);
+    call.nanoseconds = shared.nanoseconds.load(std::memory_order_relaxed);
+  }
+#endif
+  return stats;
+}
+
+void BookList::reset_stats() noexcept {
+#if BOOK_LIST_INSTRUMENTATION
+  for (SharedCallStats& shared : shared_stats) {
+    shared.calls.store(0, std::memory_order_relaxed);
+    shared.elements_scanned.store(0, std::memory_order_relaxed);
+    shared.books_copied.store(0, std::memory_order_relaxed);
+    shared.books_shifted.store(0, std::memory_order_relaxed);
+    shared.nanoseconds.store(0, std::memory_order_relaxed);
+  }
+#endif
+}
+
+void BookList::set_stats_hook(StatsHook* hook) noexcept {
+#if BOOK_LIST_INSTRUMENTATION
+  stats_hook.store(hook, std::memory_order_release);
+#else
+  static_cast<void>(hook);
+#endif
+}
+
+const char* BookList::operation_name(Operation operation) noexcept {
+  switch (operation) {
+    case Operation::size: return "size";
+    case Operation::find: return "find";
+    case Operation::at: return "at";
+    case Operation::find_by_author: return "find_by_author";
+    case Operation::find_by_title: return "find_by_title";
+    case Operation::find_priced_between: return "find_priced_between";
+    case Operation::write_to: return "write_to";
+    case Operation::compare: return "compare";
+    case Operation::diff: return "diff";
+    case Operation::insert: return "insert";
+    case Operation::insert_range: return "insert_range";
+    case Operation::remove: return "remove";
+    case Operation::move_to_top: return "move_to_top";
+    case Operation::swap: return "swap";
+    case Operation::apply: return "apply";
+    case Operation::consistency_check: return "consistency_check";
+  }
+  return "unknown";
+}
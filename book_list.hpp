@@ -3,14 +3,156 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <forward_list>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <list>
+#include <memory_resource>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "book.hpp"
+#include "book_array.hpp"
+#include "book_chunks.hpp"
+
+//
+// Consistency Validation Levels
+//
+
+// BOOK_LIST_VALIDATION_LEVEL selects, at compile time, how much work each
+// public BookList method spends verifying that the four containers still agree
+// with each other:
+//
+//   BOOK_LIST_VALIDATION_OFF      never check.
+//   BOOK_LIST_VALIDATION_SAMPLED  compare the container sizes on every call,
+//                                 and sweep the contents once every
+//                                 BOOK_LIST_VALIDATION_SAMPLE_PERIOD calls.
+//   BOOK_LIST_VALIDATION_FULL     sweep the contents on every call.
+//   BOOK_LIST_VALIDATION_DEFERRED compare the container sizes on every call,
+//                                 and sweep only the books changed since the
+//                                 last sweep when validate() is called, at
+//                                 the end of a batch or from a timer.
+//
+// Release builds (NDEBUG defined) default to off, all other builds to full.
+#define BOOK_LIST_VALIDATION_OFF      0
+#define BOOK_LIST_VALIDATION_SAMPLED  1
+#define BOOK_LIST_VALIDATION_FULL     2
+#define BOOK_LIST_VALIDATION_DEFERRED 3
+
+#ifndef BOOK_LIST_VALIDATION_LEVEL
+#  ifdef NDEBUG
+#    define BOOK_LIST_VALIDATION_LEVEL BOOK_LIST_VALIDATION_OFF
+#  else
+#    define BOOK_LIST_VALIDATION_LEVEL BOOK_LIST_VALIDATION_FULL
+#  endif
+#endif
+
+#ifndef BOOK_LIST_VALIDATION_SAMPLE_PERIOD
+#  define BOOK_LIST_VALIDATION_SAMPLE_PERIOD 64
+#endif
+
+// BOOK_LIST_HASH_INDEX, when non-zero (the default), keeps a hash index from
+// each book to its offset so find() and the duplicate check in insert() take
+// constant time instead of scanning the list. Set it to 0 to trade those
+// lookups back for the memory the index uses.
+//
+// The offsets are renumbered whenever books move: an insert or remove
+// rewrites the entry of every book below it, and move_to_top() those of every
+// book above the one moved. Only edits at the bottom rewrite none, so a list
+// built one insert(book) at a time, at the default top, rewrites a quadratic
+// number of entries. Load catalogs with append() or insert_range(), which
+// index a whole batch in one pass, as the parser, importer, snapshot loader
+// and operator>> do.
+//
+// Set it to 2 to keep only which books are in the list, not their offsets.
+// The duplicate check stays constant time, and so does a find() that misses,
+// but a find() that hits scans for the book. In exchange an insert or remove
+// no longer renumbers the books below it, which leaves positional edits as
+// cheap as the storage makes them; with the chunked storage (and the ordered
+// indexes, which also renumber, left off), that is sub-linear.
+#ifndef BOOK_LIST_HASH_INDEX
+#  define BOOK_LIST_HASH_INDEX 1
+#endif
+
+// BOOK_LIST_ORDERED_INDEXES, when non-zero, keeps sorted secondary indexes by
+// author, title and price, so find_by_author(), find_by_title() and
+// find_priced_between() take logarithmic time plus the size of their result
+// instead of scanning the list. Each index is a flat sorted vector of keys and
+// offsets, and keeping the offsets current costs every insert, remove and
+// move_to_top() a pass over all three indexes, linear in the size of the list
+// wherever the book is. So they are off by default, and the queries scan the
+// list; turn them on for lists queried far more often than they are edited.
+#ifndef BOOK_LIST_ORDERED_INDEXES
+#  define BOOK_LIST_ORDERED_INDEXES 0
+#endif
+
+// BOOK_LIST_INSTRUMENTATION, when non-zero, has each public BookList method
+// count its calls, the books it scans, copies and shifts, and the time it
+// takes, for BookList::stats() to report and a StatsHook to export. It is off
+// by default, and then records nothing and costs nothing: stats() reports
+// zeros and the hook is never called.
+#ifndef BOOK_LIST_INSTRUMENTATION
+#  define BOOK_LIST_INSTRUMENTATION 0
+#endif
+
+// BOOK_LIST_PARALLEL_THRESHOLD is the list size from which compare(), and
+// find() when there is no hash index, split their scan across
+// BOOK_LIST_PARALLEL_THREADS threads (by default, one per hardware thread).
+// They still report the first differing and the lowest matching offset. Only
+// the vector and the array can be split, so a list or the chunked container
+// stored alone is always scanned by one thread.
+#ifndef BOOK_LIST_PARALLEL_THRESHOLD
+#  define BOOK_LIST_PARALLEL_THRESHOLD 65536
+#endif
+
+#ifndef BOOK_LIST_PARALLEL_THREADS
+#  define BOOK_LIST_PARALLEL_THREADS 0
+#endif
+
+//
+// Storage Policies
+//
+
+// BOOK_LIST_STORAGE selects, at compile time, which containers BookList keeps
+// its books in. It is a bitwise OR of one or more of:
+//
+//   BOOK_LIST_STORAGE_ARRAY    the BookArray, limited to capacity() books.
+//   BOOK_LIST_STORAGE_VECTOR   the std::vector.
+//   BOOK_LIST_STORAGE_SL_LIST  the singly-linked std::forward_list.
+//   BOOK_LIST_STORAGE_DL_LIST  the doubly-linked std::list.
+//   BOOK_LIST_STORAGE_CHUNKED  the BookChunks, whose inserts and removes
+//                              shift at most a chunk of books and whose
+//                              offsets are found in logarithmic time, or in
+//                              constant time near the last edit.
+//
+// The default, BOOK_LIST_STORAGE_MIRRORED, keeps every book in the first four
+// and has the consistency checks verify they agree. Production builds can
+// pick a single container instead, such as the chunked one for lists edited
+// at arbitrary offsets; the public interface and its exceptions stay the
+// same, except that only array storage ever throws CapacityExceededException.
+#define BOOK_LIST_STORAGE_ARRAY    0x01
+#define BOOK_LIST_STORAGE_VECTOR   0x02
+#define BOOK_LIST_STORAGE_SL_LIST  0x04
+#define BOOK_LIST_STORAGE_DL_LIST  0x08
+#define BOOK_LIST_STORAGE_CHUNKED  0x10
+#define BOOK_LIST_STORAGE_MIRRORED 0x0F
+#define BOOK_LIST_STORAGE_ALL      0x1F
+
+#ifndef BOOK_LIST_STORAGE
+#  define BOOK_LIST_STORAGE BOOK_LIST_STORAGE_MIRRORED
+#endif
+
+#if (BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_ALL) == 0 \
+    || (BOOK_LIST_STORAGE & ~BOOK_LIST_STORAGE_ALL) != 0
+#  error "BOOK_LIST_STORAGE must combine one or more BOOK_LIST_STORAGE_* flags"
+#endif
 
 class BookList {
   //
@@ -22,6 +164,15 @@ class BookList {
 
   friend std::istream& operator>>(std::istream& stream, BookList& book_list);
 
+  // Walks the primary container to encode snapshots, as operator<< does.
+  friend class BookListSnapshot;
+
+  // Walks the primary container to pack its ISBNs.
+  friend class IsbnColumn;
+
+  // Walks the primary container to lay it out as columns.
+  friend class BookListColumns;
+
  public:
   //
   // Types and Exceptions
@@ -29,12 +180,97 @@ class BookList {
 
   enum class Position {TOP, BOTTOM};
 
+  // Which of the containers hold the books, according to BOOK_LIST_STORAGE.
+  static constexpr bool stores_array   = (BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_ARRAY)   != 0;
+  static constexpr bool stores_vector  = (BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_VECTOR)  != 0;
+  static constexpr bool stores_sl_list = (BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_SL_LIST) != 0;
+  static constexpr bool stores_dl_list = (BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_DL_LIST) != 0;
+  static constexpr bool stores_chunked = (BOOK_LIST_STORAGE & BOOK_LIST_STORAGE_CHUNKED) != 0;
+
+  // The capacity of a default constructed book list.
+  static constexpr std::size_t default_capacity = 11;
+
+  // The capacity of a book list that grows without limit.
+  static constexpr std::size_t unbounded_capacity = BookArray::unbounded_capacity;
+
+  // The allocator every container allocates its books and nodes with.
+  using allocator_type = std::pmr::polymorphic_allocator<Book>;
+
+  // An iterator over the books, top to bottom. It walks the primary
+  // container, the one queries read from: the vector when it is stored, then
+  // the array, the chunked container, the doubly-linked list, and finally the
+  // singly-linked list. So it is random access unless only lists are stored.
+  //
+  // Books cannot be changed in place, since the indexes key on them, so both
+  // iterator types are const.
+  using const_iterator = std::conditional_t<stores_vector,
+      std::pmr::vector<Book>::const_iterator,
+      std::conditional_t<stores_array,
+          BookArray::const_iterator,
+          std::conditional_t<stores_chunked,
+              BookChunks::const_iterator,
+              std::conditional_t<stores_dl_list,
+                  std::pmr::list<Book>::const_iterator,
+                  std::pmr::forward_list<Book>::const_iterator>>>>;
+  using iterator = const_iterator;
+  using value_type = Book;
+  using size_type = std::size_t;
+
+  // The size from which scans are split across threads, according to
+  // BOOK_LIST_PARALLEL_THRESHOLD.
+  static constexpr std::size_t parallel_threshold = BOOK_LIST_PARALLEL_THRESHOLD;
+
+  // The operations BOOK_LIST_INSTRUMENTATION keeps statistics for. Overloads
+  // share one operation, append() and operator+= count as insert_range, and
+  // consistency_check counts the internal checks the others begin and end
+  // with.
+  enum class Operation {
+    size, find, at, find_by_author, find_by_title, find_priced_between, write_to,
+    compare, diff, insert, insert_range, remove, move_to_top, swap, apply,
+    consistency_check
+  };
+
+  static constexpr std::size_t operation_count = static_cast<std::size_t>(Operation::consistency_check) + 1;
+
+  // What calls to an operation cost. Each call's counts and time include
+  // those of the operations it calls, which are also counted under their own
+  // names: an insert() includes its duplicate find() and its consistency
+  // checks.
+  struct CallStats {
+    std::uint64_t calls = 0;
+    // Books visited by walking a container or an index, including the walks
+    // std::next() takes to reach an offset in the lists.
+    std::uint64_t elements_scanned = 0;
+    // Copies made of books, where a move could not be used.
+    std::uint64_t books_copied = 0;
+    // Books moved along the array and the vector to open or close a gap.
+    std::uint64_t books_shifted = 0;
+    std::uint64_t nanoseconds = 0;
+  };
+
+  // The statistics of every operation, as stats() returns them.
+  struct Stats {
+    std::array<CallStats, operation_count> operations{};
+
+    const CallStats& operator[](Operation operation) const noexcept;
+  };
+
+  // Receives the statistics of each call as it returns, for exporting them to
+  // a metrics system. Calls to an operation made by another one are reported
+  // too, before the call that made them. The hook is called on the thread
+  // that made the call, so it must be safe to call from several threads at
+  // once, and must not throw.
+  struct StatsHook {
+    virtual ~StatsHook();
+    virtual void on_call(Operation operation, const CallStats& call) = 0;
+  };
+
   // Thrown if internal data structures become inconsistent with each other.
   struct InvalidInternalStateException : std::domain_error {
     using domain_error::domain_error;
   };
 
-  // Thrown if more books are inserted than will fit.
+  // Thrown if more books are inserted than capacity() allows.
   struct CapacityExceededException : std::length_error {
     using length_error::length_error;
   };
@@ -44,23 +280,65 @@ class BookList {
     using logic_error ::logic_error; 
   };
 
+  // Thrown if an edit script does not apply to the book list.
+  struct InvalidDiffException : std::invalid_argument {
+    using invalid_argument::invalid_argument;
+  };
+
+  // One step of an edit script, as diff() returns and apply() takes them.
+  //
+  // A REMOVE takes `book` out of the list, and `offset` is where it was. An
+  // INSERT adds `book` and a MOVE relocates it; for both, `offset` is where
+  // the book is once the whole script has been applied.
+  struct Edit {
+    enum class Kind {INSERT, REMOVE, MOVE};
+
+    Kind kind;
+    Book book;
+    std::size_t offset;
+  };
+
+  // An edit script: the removes by increasing offset, then the inserts and
+  // moves by increasing offset.
+  using Diff = std::vector<Edit>;
+
   //
   // Constructors, Assignments, and Destructor
   // 
 
-  // This constructor constructs an empty book list.
+  // This constructor constructs an empty book list holding up to
+  // default_capacity books.
   BookList();
 
-  // The copy constructor constructs a book list as a copy of another book list.
+  // This constructor constructs an empty book list holding up to `capacity`
+  // books, or any number of books if `capacity` is unbounded_capacity. No
+  // storage is set aside until books are inserted.
+  explicit BookList(std::size_t capacity);
+
+  // This constructor constructs an empty book list like the one above, whose
+  // containers all allocate from `resource`. The resource must outlive the
+  // list, and stays the list's resource for its whole life: copies of the
+  // list use the default resource unless given one, and assignments move or
+  // copy books into the list's own resource rather than adopting another.
+  //
+  // A std::pmr::monotonic_buffer_resource makes a short-lived list cheap to
+  // build, and frees it all at once when the resource goes away.
+  BookList(std::size_t capacity, std::pmr::memory_resource* resource);
+
+  // The copy constructors construct a book list as a copy of another book
+  // list, allocating from the default resource or from `resource`.
   BookList(const BookList& other);
+  BookList(const BookList& other, std::pmr::memory_resource* resource);
 
   // The move constructor constructs a book list by moving another book list.
+  // It takes over the other list's resource along with its books.
   BookList(BookList&& other); 
 
   // The copy assignment operator assigns the book list a copy of another book list.
   BookList& operator=(const BookList& rhs);
 
-  // The move assignment operator assigns the book list by moving another book list.
+  // The move assignment operator assigns the book list by moving another book
+  // list. Books from a list with a different resource are copied.
   BookList& operator=(BookList&& rhs);
 
   // This constructor constructs a book list from a list of books.
@@ -82,11 +360,64 @@ class BookList {
   // Returns the number of books in this book list.
   std::size_t size() const;
 
+  // Returns whether this book list holds no books.
+  bool empty() const;
+
+  // Returns the most books this book list may hold. Only array storage has a
+  // limit; the other storage policies return unbounded_capacity.
+  std::size_t capacity() const;
+
+  // Returns the allocator holding the resource the containers allocate from.
+  allocator_type get_allocator() const noexcept;
+
   // Returns the (zero-based) offset from the top of the list for book.
   //
-  // If the book is not in the list, returns size().
+  // If the book is not in the list, returns size(). Constant time when
+  // BOOK_LIST_HASH_INDEX is 1, linear otherwise, except that an index of
+  // membership alone answers misses in constant time.
   std::size_t find(const Book& book) const;
 
+  // Returns the book at the (zero-based) offset from the top of the list.
+  //
+  // Throws InvalidOffsetException if the offset is not less than size().
+  const Book& at(std::size_t offset_from_top) const;
+
+  // Returns the book at the (zero-based) offset from the top of the list,
+  // which must be less than size(). Unlike at(), nothing is checked, so this
+  // costs one step for the vector and the array, a logarithmic search for the
+  // chunked container, and offset steps for lists.
+  const Book& operator[](std::size_t offset_from_top) const;
+
+  // Return iterators to the top book and past the bottom one, so the list
+  // can be walked with a range-based for or handed to the standard
+  // algorithms (and, from C++20, to std::views) without copying any book.
+  //
+  // begin() checks the containers are consistent once; stepping the
+  // iterators checks nothing. Any change to the list invalidates them.
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  // Return the offsets of the books by `author`, or titled `title`, in
+  // increasing order.
+  std::vector<std::size_t> find_by_author(std::string_view author) const;
+  std::vector<std::size_t> find_by_title(std::string_view title) const;
+
+  // Returns the offsets of the books priced from `low` to `high` inclusive,
+  // cheapest first, and in increasing order among books of the same price.
+  std::vector<std::size_t> find_priced_between(double low, double high) const;
+
+  // Appends the book list to `buffer` in the text format operator<< writes to
+  // a stream with default formatting, byte for byte, and returns `buffer`.
+  // Nothing is flushed and no stream is involved.
+  std::string& write_to(std::string& buffer) const;
+
+  // Writes the book list in the same text format to `sink`, handing it
+  // chunks of about `chunk_size` bytes as they fill up.
+  void write_to(const std::function<void(std::string_view)>& sink,
+                std::size_t chunk_size = 64 * 1024) const;
+
   //
   // Mutators
   //
@@ -99,8 +430,42 @@ class BookList {
   // Adds the book before the existing book at the specified offset.
   //
   // If the book is already in the book list, the method does nothing.
+  //
+  // Besides what the storage costs, the hash index renumbers every book below
+  // the offset (see BOOK_LIST_HASH_INDEX), so inserting many books one at a
+  // time anywhere but the bottom takes quadratic time; append() them instead.
   BookList& insert(const Book& book, std::size_t offset_from_top);
 
+  // The rvalue overloads behave like the ones above, but move the book into
+  // the last container that receives it instead of copying it there.
+  BookList& insert(Book&& book, Position position = Position::TOP);
+  BookList& insert(Book&& book, std::size_t offset_from_top);
+
+  // Constructs a book from `args` and adds it to the book list in the
+  // specified position, or before the existing book at the specified offset.
+  //
+  // If the book is already in the book list, the method does nothing.
+  template <typename... Args>
+  BookList& emplace(Position position, Args&&... args);
+
+  template <typename... Args>
+  BookList& emplace(std::size_t offset_from_top, Args&&... args);
+
+  // Adds the books in [first, last) before the existing book at the
+  // specified offset, keeping their order, in one batch: duplicates are
+  // discarded in a single pass and each container is updated once.
+  //
+  // Books already in the book list, and repeats within the range, are
+  // skipped. If the remaining books would not all fit, throws
+  // CapacityExceededException without adding any of them.
+  template <typename InputIterator>
+  BookList& insert_range(std::size_t offset_from_top, InputIterator first, InputIterator last);
+
+  // Adds the books in [first, last) to the bottom of the book list in one
+  // batch, as insert_range() does.
+  template <typename InputIterator>
+  BookList& append(InputIterator first, InputIterator last);
+
   // Removes the book from the book list.
   //
   // If the book is not in the book list, the method does nothing.
@@ -109,15 +474,35 @@ class BookList {
   // Removes the book at the offset.
   //
   // If the offset is past the size of the book list, the method does nothing.
+  // As with insert(), the hash index renumbers every book below the offset.
   BookList& remove(std::size_t offset_from_top);
 
   // Locates the book, removes the book from its current location, and inserts
   // the book at the top of the book list.
+  //
+  // The book is relinked rather than copied: the lists splice its node to the
+  // front, the array and vector rotate it there, and the chunked container
+  // moves it into its first chunk.
+  //
+  // In the default build the cost is proportional to the book's offset, not
+  // constant: the lists walk to the book, the array and vector each move
+  // every book above it, and the hash index renumbers all of them, which
+  // costs the most of the four. Other builds do no better, since without
+  // offsets in the hash index the book is found by scanning down to it, and
+  // enabling BOOK_LIST_ORDERED_INDEXES adds a pass over the whole list.
+  // Recently moved books are the cheapest to move again.
   BookList& move_to_top(const Book& book);
 
-  // Swaps the book list with the `rhs` book list.
+  // Swaps the book list with the `rhs` book list. As with the std::pmr
+  // containers, both lists must use the same resource.
   void swap(BookList& rhs) noexcept;
 
+  // Allocates room for at least `count` books (but never more than
+  // capacity()) in the array and vector and in the indexes, so inserts up to
+  // that size do not need to grow them. The lists and the chunked container
+  // allocate as books arrive, so they are unaffected. The books are unchanged.
+  void reserve(std::size_t count);
+
   //
   // Comparisons
   //
@@ -128,31 +513,206 @@ class BookList {
   // book list.
   int compare(const BookList& other) const;
 
+  //
+  // Reconciliation
+  //
+
+  // Returns the shortest edit script that turns this book list into
+  // `target`: a REMOVE for each book only this list holds, an INSERT for
+  // each book only `target` holds, and a MOVE for each of the fewest shared
+  // books whose relocation leaves the rest in target's order. The books that
+  // stay put are found as the longest run of shared books already in
+  // target's relative order.
+  //
+  // Takes O(n log n) time in the number of shared books and linear time in
+  // the rest. Each book is looked up through target's hash index when
+  // BOOK_LIST_HASH_INDEX is 1, and through one built for the call otherwise.
+  Diff diff(const BookList& target) const;
+
+  // Applies the edit script that diff() returned for a list equal to this
+  // one, in one batch: the new order is laid out in a single pass over the
+  // list, then each container is rearranged once, moving its books or
+  // relinking its nodes, and the indexes are renumbered rather than rebuilt.
+  // Only the inserted books are copied. If the script does not apply, or the
+  // result would not fit, the list is left unchanged.
+  //
+  // Throws InvalidDiffException if the script removes or moves a book not in
+  // the list, places two books at one offset or past the bottom, or inserts
+  // a book the list keeps, and CapacityExceededException if the result has
+  // more books than capacity() allows.
+  BookList& apply(const Diff& diff);
+
+  //
+  // Validation
+  //
+
+  // Sweeps the books that have changed since the last call, on every
+  // container, and throws InvalidInternalStateException if the containers
+  // disagree about any of them. The changed books are tracked as one range of
+  // offsets: from the highest book an insert() or remove() reached to the
+  // bottom of the list, and from the top down to a book moved to the top.
+  //
+  // With BOOK_LIST_VALIDATION_DEFERRED this is the only sweep, so call it at
+  // the end of each batch of changes, or from a timer; a ConcurrentBookList
+  // runs it with transaction(). It finds every inconsistency a mutator could
+  // have caused, as the per-call sweeps of the full level do, but not damage
+  // done to books outside the range by other means. At the other levels it
+  // adds a sweep of the same range to theirs. Counted as a consistency_check
+  // by the instrumentation.
+  void validate();
+
+  //
+  // Instrumentation
+  //
+
+  // Returns the statistics gathered since the program started or
+  // reset_stats() was last called, summed over every book list and thread.
+  // All zero unless BOOK_LIST_INSTRUMENTATION is enabled.
+  static Stats stats() noexcept;
+
+  // Sets the statistics back to zero.
+  static void reset_stats() noexcept;
+
+  // Makes `hook` receive the statistics of every call from now on, or stops
+  // reporting them if `hook` is null. The hook must stay alive until it is
+  // replaced.
+  static void set_stats_hook(StatsHook* hook) noexcept;
+
+  // Returns the name of `operation`, as it is spelled in Operation.
+  static const char* operation_name(Operation operation) noexcept;
+
  private:
+  // The iterator over the primary container, under its internal name.
+  using primary_iterator = const_iterator;
+
+  // Whether the primary container is contiguous, so it can be indexed in
+  // constant time and split into slices.
+  static constexpr bool primary_is_contiguous = stores_vector || stores_array;
+
+  // Returns the number of books in the primary container, without checking
+  // the containers are consistent first.
+  std::size_t size_unchecked() const;
+
+  // Returns iterators to the first book and past the last book of the primary
+  // container.
+  primary_iterator primary_begin() const;
+  primary_iterator primary_end() const;
+
   // Returns whether the four containers are mutually consistent with
   // each other.
+  //
+  // How thoroughly this is checked depends on BOOK_LIST_VALIDATION_LEVEL. With
+  // validation off it always returns true.
   bool containers_are_consistent() const;
 
+  // Returns whether the stored containers hold the same number of books. This
+  // does not walk the std::forward_list.
+  bool container_sizes_are_consistent() const;
+
+  // Returns whether the stored containers hold the same books in the same
+  // order.
+  bool container_contents_are_consistent() const;
+
+  // Returns whether the stored containers hold the same number of books, and
+  // the same books from offset `first` up to (but not including) `last`.
+  // Stepping to `first` still walks the lists, but compares nothing.
+  bool container_range_is_consistent(std::size_t first, std::size_t last) const;
+
+  // Adds the books from offset `first` up to (but not including) `last`, or
+  // to the bottom of the list if `last` is unbounded_capacity, to the range
+  // validate() will sweep.
+  void mark_changed(std::size_t first, std::size_t last = unbounded_capacity) noexcept;
+
   // Returns the size of the std::forward_list, since it doesn't maintain
   // its own size.
   std::size_t books_sl_list_size() const;
 
-  // The number of books in books_array.
-  std::size_t books_array_size_ = 0;
+  // Does the work of insert_range() on books already gathered into a vector,
+  // moving them into the containers.
+  BookList& insert_books(std::size_t offset_from_top, std::vector<Book>&& books);
+
+  // An entry of an ordered index: the key of the book at `offset`. Entries
+  // are sorted by key, then by offset.
+  template <typename Key>
+  struct IndexEntry {
+    Key key;
+    std::size_t offset;
+  };
+
+  // Adds the book at `offset` to the ordered indexes, first moving the
+  // entries at and below `offset` down by one.
+  void index_book(std::size_t offset);
+
+  // Removes the book at `offset` from the ordered indexes, then moves the
+  // entries below it up by one.
+  void unindex_book(std::size_t offset);
+
+  // Brings the hash index entries of the books from offset_from_top up to
+  // (but not including) end_offset up to date with their offsets in the
+  // primary container.
+  void reindex_from(std::size_t offset_from_top, std::size_t end_offset = unbounded_capacity);
 
-  // The array container.
-  std::array<Book, 11> books_array_;
+  // The array container. Its capacity limits the size of the book list.
+  BookArray books_array_{default_capacity};
 
   // The vector container.
-  std::vector<Book> books_vector_;
+  std::pmr::vector<Book> books_vector_;
 
   // The singly-linked list container.
-  std::forward_list<Book> books_sl_list_;  
+  std::pmr::forward_list<Book> books_sl_list_;  
+
+  // The number of books in books_sl_list_, so size() need not walk it when it
+  // is the only container stored.
+  std::size_t books_sl_list_size_ = 0;
 
   // The doubly-linked list container.
-  std::list<Book> books_dl_list_;
+  std::pmr::list<Book> books_dl_list_;
+
+  // The chunked container.
+  BookChunks books_chunks_;
+
+  // Maps each book to its offset from the top. Empty unless
+  // BOOK_LIST_HASH_INDEX is enabled, and the offsets are left stale when it
+  // is 2.
+  std::pmr::unordered_map<Book, std::size_t> books_index_;
+
+  // The range of offsets changed since the last validate(); empty when
+  // `changed_first_` is not below `changed_last_`.
+  std::size_t changed_first_ = unbounded_capacity;
+  std::size_t changed_last_ = 0;
+
+  // The ordered indexes by author, title and price. Authors and titles are
+  // their StringPool handles, ordered by text. Empty unless
+  // BOOK_LIST_ORDERED_INDEXES is enabled.
+  std::pmr::vector<IndexEntry<const std::string*>> author_index_;
+  std::pmr::vector<IndexEntry<const std::string*>> title_index_;
+  std::pmr::vector<IndexEntry<double>> price_index_;
 };
 
+//
+// Template Member Definitions
+//
+
+template <typename... Args>
+BookList& BookList::emplace(Position position, Args&&... args) {
+  return insert(Book(std::forward<Args>(args)...), position);
+}
+
+template <typename... Args>
+BookList& BookList::emplace(std::size_t offset_from_top, Args&&... args) {
+  return insert(Book(std::forward<Args>(args)...), offset_from_top);
+}
+
+template <typename InputIterator>
+BookList& BookList::insert_range(std::size_t offset_from_top, InputIterator first, InputIterator last) {
+  return insert_books(offset_from_top, std::vector<Book>(first, last));
+}
+
+template <typename InputIterator>
+BookList& BookList::append(InputIterator first, InputIterator last) {
+  return insert_books(size(), std::vector<Book>(first, last));
+}
+
 //
 // Relational Operators
 //
@@ -0,0 +1,510 @@
+// Benchmarks for the BookList and Book hot paths.
+//
+// This is a standalone program, separate from the doctest runner in main.cpp.
+// Each benchmark runs on lists of every size given with --sizes (by default
+// 10 to 1,000,000 books) and reports the time and the allocations of one
+// operation, plus the bytes a list of each size holds per book.
+//
+//   book_list_benchmark [--sizes N,N,...] [--json FILE]
+//
+// --json also writes the results to FILE ("-" for standard output) as JSON,
+// for comparing one release against another.
+//
+// The consistency validation level, and the indexes and storage, are fixed
+// at compile time, so build once per configuration to compare them:
+//
+//   g++ -std=c++17 -O2 -pthread -DBOOK_LIST_VALIDATION_LEVEL=0 book.cpp book_array.cpp book_chunks.cpp book_list.cpp book_list_columns.cpp book_list_importer.cpp book_list_parser.cpp book_list_snapshot.cpp isbn_column.cpp mapped_file.cpp string_pool.cpp book_list_benchmark.cpp
+//   g++ -std=c++17 -O2 -pthread -DBOOK_LIST_VALIDATION_LEVEL=1 book.cpp book_array.cpp book_chunks.cpp book_list.cpp book_list_columns.cpp book_list_importer.cpp book_list_parser.cpp book_list_snapshot.cpp isbn_column.cpp mapped_file.cpp string_pool.cpp book_list_benchmark.cpp
+//   g++ -std=c++17 -O2 -pthread -DBOOK_LIST_VALIDATION_LEVEL=2 book.cpp book_array.cpp book_chunks.cpp book_list.cpp book_list_columns.cpp book_list_importer.cpp book_list_parser.cpp book_list_snapshot.cpp isbn_column.cpp mapped_file.cpp string_pool.cpp book_list_benchmark.cpp
+//   g++ -std=c++17 -O2 -pthread -DBOOK_LIST_VALIDATION_LEVEL=3 book.cpp book_array.cpp book_chunks.cpp book_list.cpp book_list_columns.cpp book_list_importer.cpp book_list_parser.cpp book_list_snapshot.cpp isbn_column.cpp mapped_file.cpp string_pool.cpp book_list_benchmark.cpp
+//
+// Full validation sweeps the whole list on every call, so at that level keep
+// the sizes small. Add -DBOOK_LIST_STORAGE=16 to time the chunked storage on
+// its own, or another BOOK_LIST_STORAGE combination to time that.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "allocation_counter.hpp"
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_columns.hpp"
+#include "book_list_importer.hpp"
+#include "book_list_parser.hpp"
+#include "book_list_snapshot.hpp"
+#include "isbn_column.hpp"
+
+namespace {
+  // The list sizes benchmarked unless --sizes says otherwise.
+  const std::vector<std::size_t> default_sizes = {10, 100, 1000, 10000, 100000, 1000000};
+
+  // The number of operations a benchmark performs on each fresh list.
+  // Inserting a whole million books at the top would take hours, so the
+  // mutators are timed on a batch and reported per operation. The batch is
+  // the same at every size, large enough that reading the clock is lost in
+  // it even when the list is small and each operation takes nanoseconds.
+  constexpr std::size_t batch_size = 100;
+
+  // The largest list benchmarked with operations that take time in
+  // proportion to the square of its size.
+  constexpr std::size_t quadratic_size_limit = 10000;
+
+  // Each benchmark repeats until it has been timed for at least this long...
+  constexpr std::chrono::milliseconds minimum_time{20};
+
+  // ...or has been repeated this many times.
+  constexpr std::size_t maximum_repetitions = 100000;
+
+  // Keeps the optimizer from discarding results the benchmarks never use.
+  volatile std::size_t sink = 0;
+
+  // One benchmark's cost on a list of one size.
+  struct Result {
+    std::string name;
+    std::size_t size;
+    double ns_per_op;
+    double allocations_per_op;
+    double bytes_per_op;
+  };
+
+  // The bytes a list of one size holds per book.
+  struct Footprint {
+    std::size_t size;
+    double bytes_per_book;
+  };
+
+  std::vector<Result> results;
+  std::vector<Footprint> footprints;
+
+  std::vector<Book> make_books(std::size_t count) {
+    std::vector<Book> books;
+    books.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      books.emplace_back("Title-" + std::to_string(i % 1000),
+                         "Author-" + std::to_string(i % 97),
+                         std::to_string(9780000000000 + i),
+                         10.0 + static_cast<double>(i % 50));
+    }
+    return books;
+  }
+
+  // Repeats `body` on a fresh state from `prepare`, and records the average
+  // cost of each of the `operations` operations one call of `body` performs.
+  // Only `body` is timed, and only its allocations are counted.
+  template <typename Prepare, typename Body>
+  void run(const std::string& name, std::size_t size, std::size_t operations,
+           Prepare prepare, Body body) {
+    std::chrono::steady_clock::duration elapsed{};
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    std::size_t repetitions = 0;
+    while (repetitions < maximum_repetitions && (repetitions == 0 || elapsed < minimum_time)) {
+      auto state = prepare();
+      const std::size_t allocations_before = allocation_counter::allocations.load();
+      const std::size_t bytes_before = allocation_counter::bytes_allocated.load();
+      const auto start = std::chrono::steady_clock::now();
+      body(state);
+      elapsed += std::chrono::steady_clock::now() - start;
+      allocations += allocation_counter::allocations.load() - allocations_before;
+      bytes += allocation_counter::bytes_allocated.load() - bytes_before;
+      ++repetitions;
+    }
+
+    const double count = static_cast<double>(repetitions * operations);
+    const Result result{name, size,
+                        std::chrono::duration<double, std::nano>(elapsed).count() / count,
+                        static_cast<double>(allocations) / count,
+                        static_cast<double>(bytes) / count};
+    results.push_back(result);
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setw(16) << std::setprecision(1) << result.ns_per_op << " ns/op"
+              << std::setw(10) << std::setprecision(2) << result.allocations_per_op << " allocs/op"
+              << std::setw(14) << std::setprecision(1) << result.bytes_per_op << " bytes/op\n";
+  }
+
+  // Runs a benchmark that needs no fresh state.
+  template <typename Body>
+  void run(const std::string& name, std::size_t size, std::size_t operations, Body body) {
+    run(name, size, operations, [] { return 0; }, [&](int) { body(); });
+  }
+
+  // Runs every benchmark on lists of `size` books.
+  void run_all(std::size_t size) {
+    // The list holds the first `size` books; the rest are never in it.
+    const std::size_t batch = batch_size;
+    const std::vector<Book> books = make_books(size + batch);
+    const std::vector<Book> absent(books.end() - batch, books.end());
+    BookList list(BookList::unbounded_capacity);
+    list.append(books.begin(), books.end() - batch);
+    list.validate();
+
+    // Books spread evenly over the list, for lookups to hit.
+    std::vector<Book> present;
+    for (std::size_t i = 0; i < std::min(size, batch); ++i) {
+      present.push_back(books[i * size / std::min(size, batch)]);
+    }
+
+    // A copy allocates just what the list holds.
+    const std::size_t bytes_before = allocation_counter::bytes_allocated.load();
+    {
+      const BookList copy(list);
+      footprints.push_back({size, static_cast<double>(allocation_counter::bytes_allocated.load() - bytes_before)
+                                      / static_cast<double>(size)});
+    }
+
+    std::cout << "\nlist size: " << size << ", " << std::fixed << std::setprecision(1)
+              << footprints.back().bytes_per_book << " bytes/book\n";
+
+    // A copy of the list with room reserved for a batch of inserts, as the
+    // list itself has after growing to its size. A bare copy holds exactly
+    // its books, so the first insert timed would reallocate the array, the
+    // vector and the indexes, and its cost would be charged to the batch.
+    const auto fresh_list = [&] {
+      BookList copy(list);
+      copy.reserve(size + batch);
+      return copy;
+    };
+
+    //
+    // Mutators
+    //
+
+    run("insert (top)", size, batch, fresh_list, [&](BookList& copy) {
+      for (const Book& book : absent) {
+        copy.insert(book, BookList::Position::TOP);
+      }
+    });
+
+    run("insert (middle)", size, batch, fresh_list, [&](BookList& copy) {
+      for (const Book& book : absent) {
+        copy.insert(book, size / 2);
+      }
+    });
+
+    // An editor typing books in one after another at a cursor.
+    run("insert (cursor)", size, batch, fresh_list, [&](BookList& copy) {
+      std::size_t cursor = size / 2;
+      for (const Book& book : absent) {
+        copy.insert(book, cursor++);
+      }
+    });
+
+    run("insert (bottom)", size, batch, fresh_list, [&](BookList& copy) {
+      for (const Book& book : absent) {
+        copy.insert(book, BookList::Position::BOTTOM);
+      }
+    });
+
+    // The sweep BOOK_LIST_VALIDATION_DEFERRED defers to the end of the batch
+    // covers only the books added.
+    run("insert+validate (bottom)", size, batch, fresh_list, [&](BookList& copy) {
+      for (const Book& book : absent) {
+        copy.insert(book, BookList::Position::BOTTOM);
+      }
+      copy.validate();
+    });
+
+    run("remove (top)", size, present.size(), fresh_list, [&](BookList& copy) {
+      for (std::size_t i = 0; i < present.size(); ++i) {
+        copy.remove(std::size_t{0});
+      }
+    });
+
+    run("remove (book)", size, present.size(), fresh_list, [&](BookList& copy) {
+      for (const Book& book : present) {
+        copy.remove(book);
+      }
+    });
+
+    run("move_to_top", size, present.size(), fresh_list, [&](BookList& copy) {
+      for (const Book& book : present) {
+        copy.move_to_top(book);
+      }
+    });
+
+    BookList additions(BookList::unbounded_capacity);
+    additions.append(absent.begin(), absent.end());
+    run("operator+=", size, 1, fresh_list, [&](BookList& copy) { copy += additions; });
+
+    // Syncing with a feed that differs by a few removes, inserts and moves.
+    BookList feed(list);
+    for (std::size_t i = 0; i < present.size() / 4; ++i) {
+      feed.remove(present[i]);
+      feed.insert(absent[i], feed.size() / 2);
+      feed.move_to_top(present[present.size() - 1 - i]);
+    }
+    run("diff (few changes)", size, 1, [&] { sink = sink + list.diff(feed).size(); });
+    const BookList::Diff script = list.diff(feed);
+    run("apply (few changes)", size, 1, fresh_list, [&](BookList& copy) { copy.apply(script); });
+
+    BookList other(list);
+    run("swap", size, 2, [&] {
+      for (int i = 0; i < 2; ++i) {
+        list.swap(other);
+      }
+    });
+
+    //
+    // Queries
+    //
+
+    run("size", size, 1, [&] { sink = sink + list.size(); });
+
+    run("find (hit)", size, present.size(), [&] {
+      for (const Book& book : present) {
+        sink = sink + list.find(book);
+      }
+    });
+
+    run("find (miss)", size, 1, [&] { sink = sink + list.find(absent.front()); });
+
+    run("compare (equal)", size, 1, [&] { sink = sink + (list == other); });
+
+    run("find_by_author", size, 1, [&] { sink = sink + list.find_by_author("Author-1").size(); });
+
+    run("find_priced_between", size, 1, [&] {
+      sink = sink + list.find_priced_between(12.0, 15.0).size();
+    });
+
+    run("iterate", size, size, [&] {
+      double total = 0.0;
+      for (const Book& book : list) {
+        total += book.price();
+      }
+      sink = sink + static_cast<std::size_t>(total);
+    });
+
+    const IsbnColumn isbns(list);
+    run("find_by_isbn (hit)", size, present.size(), [&] {
+      for (const Book& book : present) {
+        sink = sink + isbns.find_by_isbn(book.isbn());
+      }
+    });
+
+    run("find_by_isbn (miss)", size, 1, [&] { sink = sink + isbns.find_by_isbn("9790000000000"); });
+
+    run("IsbnColumn::invalid", size, size, [&] { sink = sink + isbns.invalid().size(); });
+
+    const BookListColumns columns(list);
+    run("total price (columns)", size, size, [&] {
+      sink = sink + static_cast<std::size_t>(columns.total_price());
+    });
+
+    //
+    // Text and Binary Formats
+    //
+
+    run("operator<<", size, size, [&] {
+      std::ostringstream stream;
+      stream << list;
+      sink = sink + stream.str().size();
+    });
+
+    std::string buffer;
+    run("write_to", size, size, [&] {
+      buffer.clear();
+      sink = sink + list.write_to(buffer).size();
+    });
+
+    // operator>> inserts the books one at a time, each insert costing time in
+    // proportion to the list, so it is skipped for lists too large to read
+    // that way in reasonable time. It skips only four characters before each
+    // record, so it gets the short row labels it can read rather than
+    // operator<<'s.
+    if (size <= quadratic_size_limit) {
+      std::string short_labels = std::to_string(size) + '\n';
+      for (const Book& book : list) {
+        short_labels += " 0: ";
+        book.write_to(short_labels);
+      }
+      run("operator>>", size, size, [&] {
+        std::istringstream stream(short_labels);
+        BookList read(BookList::unbounded_capacity);
+        stream >> read;
+        sink = sink + read.size();
+      });
+    }
+
+    run("round trip (stream)", size, size, [&] {
+      std::ostringstream stream;
+      stream << list;
+      const std::string text = stream.str();
+      BookList read(BookList::unbounded_capacity);
+      BookListParser(text).parse_into(read);
+      sink = sink + read.size();
+    });
+
+    run("round trip (write_to)", size, size, [&] {
+      buffer.clear();
+      list.write_to(buffer);
+      BookList read(BookList::unbounded_capacity);
+      BookListParser(buffer).parse_into(read);
+      sink = sink + read.size();
+    });
+
+    // The same text read straight from memory, and through the importer's
+    // pipeline from a stream, whose parsing spreads over the hardware threads.
+    run("parse_into", size, size, [&] {
+      BookList read(BookList::unbounded_capacity);
+      BookListParser(buffer).parse_into(read);
+      sink = sink + read.size();
+    });
+
+    run("import (pipelined)", size, size, [&] {
+      std::istringstream stream(buffer);
+      BookList read(BookList::unbounded_capacity);
+      sink = sink + BookListImporter().import(stream, read).books_added;
+    });
+
+    run("snapshot encode", size, size, [&] {
+      sink = sink + BookListSnapshot::encode(list).size();
+    });
+
+    const std::string image = BookListSnapshot::encode(list);
+    run("snapshot decode", size, size, [&] {
+      sink = sink + BookListSnapshot::decode(image).size();
+    });
+
+    //
+    // Books
+    //
+
+    // Titles and authors too long for the small string buffer, so copying
+    // them would allocate, read through non-const books, and rebuilt from
+    // views of text that is already pooled.
+    std::vector<Book> long_books;
+    std::vector<std::string> long_titles;
+    for (std::size_t i = 0; i < batch; ++i) {
+      long_titles.push_back("A title long enough to allocate " + std::to_string(i));
+      long_books.emplace_back(long_titles.back(), "An author long enough to allocate",
+                              std::to_string(9780000000000 + i), 10.0);
+    }
+
+    run("Book accessors", size, long_books.size(), [&] {
+      for (Book& book : long_books) {
+        sink = sink + book.title().size() + book.author().size() + book.isbn().size();
+      }
+    });
+
+    run("Book(string_view)", size, long_books.size(), [&] {
+      for (const Book& book : long_books) {
+        const Book rebuilt(book.title(), book.author(), book.isbn(), book.price());
+        sink = sink + rebuilt.hash();
+      }
+    });
+
+    run("Book setters", size, long_books.size(), [&] {
+      for (std::size_t i = 0; i < long_books.size(); ++i) {
+        const Book& next = long_books[(i + 1) % long_books.size()];
+        long_books[i].title(next.title()).isbn(next.isbn());
+        sink = sink + long_books[i].hash();
+      }
+    });
+  }
+
+  // Writes `text` as a JSON string.
+  void write_json_string(std::ostream& stream, std::string_view text) {
+    stream << '"';
+    for (const char c : text) {
+      if (c == '"' || c == '\\') {
+        stream << '\\';
+      }
+      stream << c;
+    }
+    stream << '"';
+  }
+
+  void write_json(std::ostream& stream) {
+    stream << std::setprecision(6) << std::defaultfloat
+           << "{\n  \"configuration\": {\"validation_level\": " << BOOK_LIST_VALIDATION_LEVEL
+           << ", \"storage\": " << BOOK_LIST_STORAGE
+           << ", \"hash_index\": " << BOOK_LIST_HASH_INDEX
+           << ", \"ordered_indexes\": " << BOOK_LIST_ORDERED_INDEXES << "},\n";
+
+    stream << "  \"footprints\": [";
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+      stream << (i == 0 ? "\n" : ",\n") << "    {\"size\": " << footprints[i].size
+             << ", \"bytes_per_book\": " << footprints[i].bytes_per_book << '}';
+    }
+    stream << "\n  ],\n";
+
+    stream << "  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const Result& result = results[i];
+      stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+      write_json_string(stream, result.name);
+      stream << ", \"size\": " << result.size
+             << ", \"ns_per_op\": " << result.ns_per_op
+             << ", \"allocations_per_op\": " << result.allocations_per_op
+             << ", \"bytes_per_op\": " << result.bytes_per_op << '}';
+    }
+    stream << "\n  ]\n}\n";
+  }
+
+  // Parses a comma separated list of sizes, or returns an empty list.
+  std::vector<std::size_t> parse_sizes(const std::string& text) {
+    std::vector<std::size_t> sizes;
+    std::istringstream stream(text);
+    std::string size;
+    while (std::getline(stream, size, ',')) {
+      try {
+        sizes.push_back(std::stoul(size));
+      } catch (const std::exception&) {
+        return {};
+      }
+      if (sizes.back() == 0) {
+        return {};
+      }
+    }
+    return sizes;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<std::size_t> sizes = default_sizes;
+  std::string json_path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument = argv[i];
+    if (argument == "--sizes" && i + 1 < argc) {
+      sizes = parse_sizes(argv[++i]);
+    } else if (argument == "--json" && i + 1 < argc) {
+      json_path = argv[++i];
+    } else {
+      sizes.clear();
+    }
+    if (sizes.empty()) {
+      std::cerr << "usage: " << argv[0] << " [--sizes N,N,...] [--json FILE]\n";
+      return 2;
+    }
+  }
+
+  std::cout << "validation level: " << BOOK_LIST_VALIDATION_LEVEL
+            << ", storage: " << BOOK_LIST_STORAGE
+            << ", hash index: " << BOOK_LIST_HASH_INDEX
+            << ", ordered indexes: " << BOOK_LIST_ORDERED_INDEXES << '\n';
+  for (const std::size_t size : sizes) {
+    run_all(size);
+  }
+
+  if (json_path == "-") {
+    write_json(std::cout);
+  } else if (!json_path.empty()) {
+    std::ofstream file(json_path);
+    write_json(file);
+    if (!file) {
+      std::cerr << "could not write " << json_path << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
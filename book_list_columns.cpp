@@ -0,0 +1,130 @@
+#include "book_list_columns.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookListColumns::BookListColumns(const BookList& books) {
+  refresh(books);
+}
+
+//
+// Columns
+//
+
+std::size_t BookListColumns::size() const noexcept {
+  return prices_.size();
+}
+
+const std::vector<double>& BookListColumns::prices() const noexcept {
+  return prices_;
+}
+
+const std::vector<std::uint64_t>& BookListColumns::isbn_keys() const noexcept {
+  return isbn_keys_;
+}
+
+const std::vector<BookListColumns::AuthorHandle>& BookListColumns::authors() const noexcept {
+  return authors_;
+}
+
+//
+// Aggregations
+//
+// The loops below index plain arrays and keep no state between rows beyond
+// their accumulators, so the compiler can turn them into vector code.
+//
+
+double BookListColumns::total_price() const noexcept {
+  // Four running sums, rather than one, let four additions proceed at once
+  // without reordering any single sum.
+  const double* prices = prices_.data();
+  const std::size_t count = prices_.size();
+  double sums[4] = {0.0, 0.0, 0.0, 0.0};
+  std::size_t row = 0;
+  for (; row + 4 <= count; row += 4) {
+    sums[0] += prices[row];
+    sums[1] += prices[row + 1];
+    sums[2] += prices[row + 2];
+    sums[3] += prices[row + 3];
+  }
+  for (; row < count; ++row) {
+    sums[0] += prices[row];
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+std::pair<double, double> BookListColumns::price_range() const {
+  if (prices_.empty()) {
+    throw std::out_of_range("No prices to range over in price_range");
+  }
+
+  const double* prices = prices_.data();
+  double low = prices[0];
+  double high = prices[0];
+  for (std::size_t row = 1; row < prices_.size(); ++row) {
+    low = prices[row] < low ? prices[row] : low;
+    high = prices[row] > high ? prices[row] : high;
+  }
+  return {low, high};
+}
+
+std::size_t BookListColumns::count_priced_between(double low, double high) const noexcept {
+  const double* prices = prices_.data();
+  std::size_t count = 0;
+  for (std::size_t row = 0; row < prices_.size(); ++row) {
+    count += static_cast<std::size_t>((prices[row] >= low) & (prices[row] <= high));
+  }
+  return count;
+}
+
+std::vector<std::size_t> BookListColumns::priced_between(double low, double high) const {
+  std::vector<std::size_t> offsets;
+  offsets.reserve(count_priced_between(low, high));
+  for (std::size_t row = 0; row < prices_.size(); ++row) {
+    if (prices_[row] >= low && prices_[row] <= high) {
+      offsets.push_back(row);
+    }
+  }
+  return offsets;
+}
+
+std::unordered_map<BookListColumns::AuthorHandle, double> BookListColumns::total_price_by_author() const {
+  std::unordered_map<AuthorHandle, double> totals;
+  for (std::size_t row = 0; row < size(); ++row) {
+    totals[authors_[row]] += prices_[row];
+  }
+  return totals;
+}
+
+//
+// Mutators
+//
+
+void BookListColumns::refresh(const BookList& books, std::size_t first_changed) {
+  const std::size_t count = books.size();
+  first_changed = std::min({first_changed, count, size()});
+
+  prices_.resize(count);
+  isbn_keys_.resize(count);
+  authors_.resize(count);
+
+  auto position = std::next(books.primary_begin(), first_changed);
+  for (std::size_t row = first_changed; row < count; ++row, ++position) {
+    prices_[row] = position->price();
+    isbn_keys_[row] = position->isbn_key();
+    authors_[row] = &position->author();
+  }
+}
@@ -0,0 +1,70 @@
+// Unit tests for the BookListColumns class.
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_columns.hpp"
+#include "doctest.hpp"
+
+TEST_CASE("BookListColumns") {
+  const Book book_1("title_1", "author_a", "isbn_1", 4.0),
+      book_2("title_2", "author_b", "isbn_2", 1.5),
+      book_3("title_3", "author_a", "isbn_3", 10.0),
+      book_4("title_4", "author_b", "isbn_4", 2.5),
+      book_5("title_5", "author_c", "isbn_5", 7.0);
+
+  BookList list({book_1, book_2, book_3, book_4, book_5});
+  BookListColumns columns(list);
+
+  SUBCASE("Columns") {
+    CHECK_EQ(5U, columns.size());
+    CHECK_EQ(std::vector<double>({4.0, 1.5, 10.0, 2.5, 7.0}), columns.prices());
+    CHECK_EQ(book_3.isbn_key(), columns.isbn_keys()[2]);
+    CHECK_EQ(&book_1.author(), columns.authors()[0]);
+    CHECK_EQ(columns.authors()[0], columns.authors()[2]);
+  }
+
+  SUBCASE("Aggregations") {
+    CHECK_EQ(25.0, columns.total_price());
+    CHECK_EQ(std::make_pair(1.5, 10.0), columns.price_range());
+    CHECK_EQ(3U, columns.count_priced_between(2.5, 7.0));
+    CHECK_EQ(std::vector<std::size_t>({0, 3, 4}), columns.priced_between(2.5, 7.0));
+    CHECK(columns.priced_between(20.0, 30.0).empty());
+
+    const auto totals = columns.total_price_by_author();
+    CHECK_EQ(3U, totals.size());
+    CHECK_EQ(14.0, totals.at(&book_1.author()));
+    CHECK_EQ(4.0, totals.at(&book_2.author()));
+    CHECK_EQ(7.0, totals.at(&book_5.author()));
+  }
+
+  SUBCASE("EmptyList") {
+    const BookListColumns empty{BookList()};
+    CHECK_EQ(0U, empty.size());
+    CHECK_EQ(0.0, empty.total_price());
+    CHECK_EQ(0U, empty.count_priced_between(0.0, 100.0));
+    CHECK_THROWS_AS(empty.price_range(), std::out_of_range);
+  }
+
+  SUBCASE("Refresh") {
+    // Rows above the first changed offset are kept as they were.
+    list.remove(book_5).insert(Book("title_6", "author_c", "isbn_6", 3.0), BookList::Position::BOTTOM);
+    columns.refresh(list, 4);
+    CHECK_EQ(std::vector<double>({4.0, 1.5, 10.0, 2.5, 3.0}), columns.prices());
+
+    list.remove(book_3);
+    columns.refresh(list, 2);
+    CHECK_EQ(std::vector<double>({4.0, 1.5, 2.5, 3.0}), columns.prices());
+
+    list.move_to_top(book_4);
+    columns.refresh(list);
+    CHECK_EQ(std::vector<double>({2.5, 4.0, 1.5, 3.0}), columns.prices());
+    CHECK_EQ(11.0, columns.total_price());
+  }
+}
@@ -0,0 +1,399 @@
+#include "book_list_importer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_parser.hpp"
+
+namespace {
+  // A slice of the input holding whole records, numbered in reading order.
+  struct Chunk {
+    std::size_t sequence = 0;
+    std::string text;
+
+    // The line of the input the text starts on, and the bytes of input it
+    // accounts for, which for the first chunk include the book count.
+    std::size_t first_line = 1;
+    std::size_t bytes = 0;
+  };
+
+  // A chunk once parsed: its books, or the error parsing it threw. The text
+  // is kept so the writer can parse it again if the error may lie past the
+  // book count.
+  struct ParsedChunk {
+    Chunk chunk;
+    std::vector<Book> books;
+    std::exception_ptr error;
+  };
+
+  ParsedChunk parse(Chunk&& chunk) {
+    ParsedChunk parsed{std::move(chunk), {}, nullptr};
+    try {
+      parsed.books = BookListParser::parse_records(parsed.chunk.text, parsed.chunk.first_line);
+    } catch (...) {
+      parsed.error = std::current_exception();
+    }
+    return parsed;
+  }
+
+  // Advances the 1-based `line`, and the `column` of characters read on it,
+  // past `text`.
+  void advance(std::string_view text, std::size_t& line, std::size_t& column) {
+    const std::size_t newlines = static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+    if (newlines == 0) {
+      column += text.size();
+    } else {
+      line += newlines;
+      column = text.size() - text.rfind('\n') - 1;
+    }
+  }
+
+  // The state the stages of one import share. Everything below the mutex is
+  // guarded by it, and every change to it is signalled on `changed_`.
+  class Pipeline {
+   public:
+    Pipeline(std::istream& stream, std::size_t chunk_size, std::size_t queue_capacity, std::size_t window)
+        : stream_(stream), block_(chunk_size, '\0'), queue_capacity_(queue_capacity), window_(window) {}
+
+    // The reader stage: reads until the input ends, an error occurs, or the
+    // import is cancelled, waiting while the queue or the window is full.
+    void read_all() {
+      while (wait_for_room() && read_block()) {
+      }
+    }
+
+    // The worker stage: parses chunks from the queue until it is drained and
+    // the reader has finished, or the import is cancelled.
+    void parse_all() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      for (;;) {
+        changed_.wait(lock, [this] { return cancelled_ || !queue_.empty() || read_done_; });
+        if (cancelled_ || queue_.empty()) {
+          return;
+        }
+        Chunk chunk = std::move(queue_.front());
+        queue_.pop_front();
+        changed_.notify_all();
+
+        lock.unlock();
+        ParsedChunk parsed = parse(std::move(chunk));
+        lock.lock();
+        parsed_.emplace(parsed.chunk.sequence, std::move(parsed));
+        changed_.notify_all();
+      }
+    }
+
+    // The writer stage: adds the books of each chunk to `book_list` in
+    // reading order until `count` books have been read, and returns the
+    // final progress. Without a reader thread, the writer reads for itself.
+    BookListImporter::Progress write_all(BookList& book_list, bool reader_running,
+                                         const BookListImporter::ProgressHandler& handler) {
+      BookListImporter::Progress progress;
+      bool read_here = !reader_running;
+      for (;;) {
+        ParsedChunk parsed;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          const auto ready = [this] {
+            return parsed_.count(written_) != 0 ||
+                   (!queue_.empty() && queue_.front().sequence == written_) ||
+                   (read_done_ && read_ == written_);
+          };
+          while (!ready() && !(header_read_ && progress.books_parsed == count_)) {
+            if (read_here) {
+              lock.unlock();
+              read_here = read_block();
+              lock.lock();
+            } else {
+              changed_.wait(lock);
+            }
+          }
+          progress.book_count = count_;
+          if (header_read_ && progress.books_parsed == count_) {
+            break;
+          }
+
+          if (const auto found = parsed_.find(written_); found != parsed_.end()) {
+            parsed = std::move(found->second);
+            parsed_.erase(found);
+          } else if (!queue_.empty() && queue_.front().sequence == written_) {
+            // No worker has taken the chunk the writer needs next, so rather
+            // than wait, parse it here.
+            Chunk chunk = std::move(queue_.front());
+            queue_.pop_front();
+            changed_.notify_all();
+            lock.unlock();
+            parsed = parse(std::move(chunk));
+          } else if (read_error_) {
+            std::rethrow_exception(read_error_);
+          } else {
+            throw BookListParser::ParseError("expected " + std::to_string(count_) + " books but found " +
+                                                 std::to_string(progress.books_parsed),
+                                             end_line_, end_column_ + 1);
+          }
+        }
+
+        // Only the records up to the count are read, so an error past it is
+        // no error: parse just those.
+        const std::size_t remaining = progress.book_count - progress.books_parsed;
+        if (parsed.error) {
+          parsed.books =
+              BookListParser::parse_records(parsed.chunk.text, parsed.chunk.first_line, remaining);
+        } else if (parsed.books.size() > remaining) {
+          parsed.books.erase(parsed.books.begin() + static_cast<std::ptrdiff_t>(remaining), parsed.books.end());
+        }
+
+        const std::size_t size_before = book_list.size();
+        book_list.append(std::make_move_iterator(parsed.books.begin()), std::make_move_iterator(parsed.books.end()));
+        progress.bytes_read += parsed.chunk.bytes;
+        progress.books_parsed += parsed.books.size();
+        progress.books_added += book_list.size() - size_before;
+        {
+          const std::lock_guard<std::mutex> lock(mutex_);
+          ++written_;
+          changed_.notify_all();
+        }
+        if (handler) {
+          handler(progress);
+        }
+      }
+      return progress;
+    }
+
+    // Stops the other stages at their next wait.
+    void cancel() {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      cancelled_ = true;
+      changed_.notify_all();
+    }
+
+   private:
+    // Waits until another chunk may be read, and returns false if the import
+    // was cancelled instead.
+    bool wait_for_room() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [this] {
+        return cancelled_ || (queue_.size() < queue_capacity_ && read_ - written_ < window_);
+      });
+      return !cancelled_;
+    }
+
+    // Reads one block, queueing the whole records it completes, and returns
+    // whether there is more to read. Any error ends the reading, to be thrown
+    // by the writer once the chunks before it are added.
+    bool read_block() {
+      try {
+        stream_.read(block_.data(), static_cast<std::streamsize>(block_.size()));
+        if (stream_.bad()) {
+          throw BookListImporter::ReadException("BookListImporter: cannot read the input");
+        }
+        const std::size_t length = static_cast<std::size_t>(stream_.gcount());
+        const bool at_end = length < block_.size();
+        pending_.append(block_, 0, length);
+
+        if (!header_read_) {
+          const std::size_t count = read_header(at_end);
+          if (count_bytes_ == 0) {
+            return true;
+          }
+          const std::lock_guard<std::mutex> lock(mutex_);
+          count_ = count;
+          header_read_ = true;
+          changed_.notify_all();
+        }
+
+        // Cut after the last newline outside quotes, remembering where the
+        // scan stopped and whether it stopped inside a quoted field.
+        std::size_t cut = 0;
+        for (; scanned_ < pending_.size(); ++scanned_) {
+          const char c = pending_[scanned_];
+          if (escaped_) {
+            escaped_ = false;
+          } else if (in_quotes_) {
+            escaped_ = c == '\\';
+            in_quotes_ = c != '"';
+          } else if (c == '"') {
+            in_quotes_ = true;
+          } else if (c == '\n') {
+            cut = scanned_ + 1;
+          }
+        }
+        if (at_end) {
+          cut = pending_.size();
+        }
+        if (cut != 0) {
+          Chunk chunk;
+          chunk.first_line = line_;
+          chunk.bytes = cut + count_bytes_;
+          chunk.text.assign(pending_, 0, cut);
+          pending_.erase(0, cut);
+          scanned_ -= cut;
+          count_bytes_ = 0;
+          advance(chunk.text, line_, column_);
+
+          const std::lock_guard<std::mutex> lock(mutex_);
+          chunk.sequence = read_++;
+          queue_.push_back(std::move(chunk));
+          changed_.notify_all();
+        }
+
+        if (at_end) {
+          const std::lock_guard<std::mutex> lock(mutex_);
+          end_line_ = line_;
+          end_column_ = column_;
+          read_done_ = true;
+          changed_.notify_all();
+        }
+        return !at_end;
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        read_error_ = std::current_exception();
+        read_done_ = true;
+        changed_.notify_all();
+        return false;
+      }
+    }
+
+    // Reads the book count once the line holding it is in, or the input
+    // ends, and returns it, dropping it and the rest of its line from the
+    // pending text. Leaves count_bytes_ zero while more input is needed.
+    //
+    // Throws BookListParser::ParseError if the input does not start with a
+    // count.
+    std::size_t read_header(bool at_end) {
+      const std::size_t first = pending_.find_first_not_of(" \t\r\n");
+      if (!at_end && (first == std::string::npos || pending_.find('\n', first) == std::string::npos)) {
+        return 0;
+      }
+      const BookListParser header(pending_);
+      std::size_t end = header.position();
+      const std::size_t rest = pending_.find_first_not_of(" \t\r", end);
+      if (rest != std::string::npos && pending_[rest] == '\n') {
+        end = rest + 1;
+      }
+      advance(std::string_view(pending_).substr(0, end), line_, column_);
+      pending_.erase(0, end);
+      count_bytes_ = end;
+      return header.count();
+    }
+
+    // Used by the reader only.
+    std::istream& stream_;
+    std::string block_;
+    std::string pending_;
+    std::size_t scanned_ = 0;
+    bool in_quotes_ = false;
+    bool escaped_ = false;
+    std::size_t line_ = 1;
+    std::size_t column_ = 0;
+    std::size_t count_bytes_ = 0;
+
+    const std::size_t queue_capacity_;
+    const std::size_t window_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+
+    // The book count, once read.
+    bool header_read_ = false;
+    std::size_t count_ = 0;
+
+    // The chunks waiting to be parsed, and those parsed but not yet added.
+    std::deque<Chunk> queue_;
+    std::map<std::size_t, ParsedChunk> parsed_;
+
+    // The number of chunks read, and of chunks added.
+    std::size_t read_ = 0;
+    std::size_t written_ = 0;
+
+    // Whether the reader has finished, the error that stopped it if any, and
+    // where the input ended.
+    bool read_done_ = false;
+    std::exception_ptr read_error_;
+    std::size_t end_line_ = 1;
+    std::size_t end_column_ = 0;
+
+    bool cancelled_ = false;
+  };
+
+  // Cancels and joins the threads of a pipeline however the import ends.
+  struct Stages {
+    Pipeline& pipeline;
+    std::vector<std::thread> threads;
+
+    ~Stages() {
+      pipeline.cancel();
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+  };
+}
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookListImporter::BookListImporter(std::size_t threads, std::size_t chunk_size, std::size_t queue_capacity)
+    : threads_(threads != 0 ? threads : std::max(1U, std::thread::hardware_concurrency())),
+      chunk_size_(std::max<std::size_t>(chunk_size, 1)),
+      queue_capacity_(std::max<std::size_t>(queue_capacity, 1)) {}
+
+//
+// Configuration
+//
+
+BookListImporter& BookListImporter::on_progress(ProgressHandler handler) {
+  progress_handler_ = std::move(handler);
+  return *this;
+}
+
+//
+// Importing
+//
+
+BookListImporter::Progress BookListImporter::import(std::istream& stream, BookList& book_list) const {
+  Pipeline pipeline(stream, chunk_size_, queue_capacity_, queue_capacity_ + threads_);
+  Stages stages{pipeline, {}};
+  stages.threads.reserve(threads_ + 1);
+
+  // A stage that cannot get a thread of its own is left to the writer, which
+  // reads and parses whatever it would otherwise wait for.
+  bool reader_running = true;
+  try {
+    stages.threads.emplace_back([&pipeline] { pipeline.read_all(); });
+  } catch (const std::system_error&) {
+    reader_running = false;
+  }
+  for (std::size_t worker = 0; worker < threads_; ++worker) {
+    try {
+      stages.threads.emplace_back([&pipeline] { pipeline.parse_all(); });
+    } catch (const std::system_error&) {
+      break;
+    }
+  }
+  return pipeline.write_all(book_list, reader_running, progress_handler_);
+}
+
+BookListImporter::Progress BookListImporter::import_file(const std::string& path, BookList& book_list) const {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw ReadException("BookListImporter: cannot open " + path);
+  }
+  return import(file, book_list);
+}
@@ -0,0 +1,115 @@
+#ifndef _book_list_importer_hpp_
+#define _book_list_importer_hpp_
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "book_list.hpp"
+
+// The BookListImporter class reads the text format operator<< writes for a
+// BookList, as BookListParser does, but as a pipeline of three stages, so a
+// large catalog is read, parsed and inserted at the same time:
+//
+//   1. A reader thread reads the input `chunk_size` bytes at a time and cuts
+//      it into chunks of whole records, at newlines outside quotes.
+//   2. Worker threads parse the chunks with BookListParser::parse_records(),
+//      several at once.
+//   3. The thread that called import() is the only writer: it adds each
+//      chunk's books to the list with BookList::append(), one batch per
+//      chunk, in the order the chunks were read.
+//
+// At most `queue_capacity` chunks wait to be parsed, and no more than that
+// plus one per worker are read but not yet added, so a reader faster than
+// the parsers, or parsers faster than the writer, waits instead of reading
+// the whole input into memory. The writer also parses a chunk itself when it
+// would otherwise wait for one no worker has taken, so an import finishes
+// even if no worker thread can be started.
+//
+// The book list is only touched by the thread that called import(), as is
+// the progress handler, which is called after each chunk is added.
+class BookListImporter {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  // Thrown if the input cannot be read.
+  struct ReadException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  // How far an import has got.
+  struct Progress {
+    // The bytes of input read and parsed.
+    std::size_t bytes_read = 0;
+
+    // The records parsed, and the books added. Books already in the list, or
+    // repeated in the input, are parsed but not added.
+    std::size_t books_parsed = 0;
+    std::size_t books_added = 0;
+
+    // The number of books the input says it holds.
+    std::size_t book_count = 0;
+  };
+
+  using ProgressHandler = std::function<void(const Progress& progress)>;
+
+  // The defaults: chunks of 1 MiB, of which at most 8 wait to be parsed.
+  static constexpr std::size_t default_chunk_size = 1 << 20;
+  static constexpr std::size_t default_queue_capacity = 8;
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor prepares imports that parse on `threads` worker threads
+  // (one per hardware thread if zero), read `chunk_size` bytes at a time,
+  // and let at most `queue_capacity` chunks wait to be parsed.
+  explicit BookListImporter(std::size_t threads = 0,
+                            std::size_t chunk_size = default_chunk_size,
+                            std::size_t queue_capacity = default_queue_capacity);
+
+  //
+  // Configuration
+  //
+
+  // Makes `handler` receive the progress of every later import, after each
+  // chunk is added, or stops reporting it if `handler` is empty.
+  BookListImporter& on_progress(ProgressHandler handler);
+
+  //
+  // Importing
+  //
+
+  // Reads a book list from `stream` and adds its books to the bottom of
+  // `book_list` in their original order, skipping books already in the list
+  // as BookList::append() does. Returns the final progress.
+  //
+  // As with BookListParser, only the first count records are read, and input
+  // that is malformed, or holds fewer records than its count, throws
+  // BookListParser::ParseError naming the line and column. Books from the
+  // chunks before the one in error have been added by then, as operator>>
+  // keeps the books it read before a bad record. The stream is read ahead, so
+  // it is left somewhere past the last record read.
+  //
+  // Throws ReadException if the stream fails other than by ending, and
+  // whatever BookList::append() throws, such as
+  // BookList::CapacityExceededException.
+  Progress import(std::istream& stream, BookList& book_list) const;
+
+  // Imports the book list in the file at `path`, as import() does.
+  //
+  // Throws ReadException if the file cannot be opened or read.
+  Progress import_file(const std::string& path, BookList& book_list) const;
+
+ private:
+  std::size_t threads_;
+  std::size_t chunk_size_;
+  std::size_t queue_capacity_;
+  ProgressHandler progress_handler_;
+};
+
+#endif
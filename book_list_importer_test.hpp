@@ -0,0 +1,162 @@
+// Unit tests for the BookListImporter class.
+
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_importer.hpp"
+#include "book_list_parser.hpp"
+#include "doctest.hpp"
+#include "temporary_path.hpp"
+
+TEST_CASE("BookListImporter") {
+  BookList list(BookList::unbounded_capacity);
+  for (int i = 0; i < 200; ++i) {
+    list.insert(Book("Title \"" + std::to_string(i) + "\"\nsecond line", "Back\\slash, " + std::to_string(i % 7),
+                     "isbn-" + std::to_string(i), i / 4.0),
+                BookList::Position::BOTTOM);
+  }
+  std::ostringstream stream;
+  stream << list;
+  const std::string text = stream.str();
+
+  // Reads `input` with chunks of `chunk_size` bytes into a new list, or
+  // returns the line and column of the error that stopped it.
+  const auto error_at = [](const std::string& input, std::size_t chunk_size) {
+    std::istringstream in(input);
+    BookList imported(BookList::unbounded_capacity);
+    try {
+      BookListImporter(3, chunk_size, 2).import(in, imported);
+    } catch (const BookListParser::ParseError& error) {
+      return std::to_string(error.line()) + ":" + std::to_string(error.column());
+    }
+    return std::string("no error");
+  };
+
+  SUBCASE("ReadsWhatOperatorInsertionWrites") {
+    // Chunks far smaller than a record, of about one record, and holding the
+    // whole list cut records, quoted newlines and escapes every way.
+    for (const std::size_t chunk_size : {1U, 7U, 64U, 100000U}) {
+      for (const std::size_t threads : {1U, 4U}) {
+        std::istringstream in(text);
+        BookList imported(BookList::unbounded_capacity);
+        const BookListImporter::Progress progress = BookListImporter(threads, chunk_size, 1).import(in, imported);
+        CHECK_EQ(list, imported);
+        // Whitespace after the last record is read with it unless it falls in
+        // a chunk of its own, after the count is reached.
+        CHECK(text.find_last_not_of('\n') < progress.bytes_read);
+        CHECK(progress.bytes_read <= text.size());
+        CHECK_EQ(list.size(), progress.books_parsed);
+        CHECK_EQ(list.size(), progress.books_added);
+        CHECK_EQ(list.size(), progress.book_count);
+      }
+    }
+  }
+
+  SUBCASE("AppendsToTheList") {
+    BookList imported(BookList::unbounded_capacity);
+    imported += {Book("First", "Author", "isbn-first", 1), list.at(5)};
+    std::istringstream in(text);
+    const BookListImporter::Progress progress = BookListImporter(2, 256).import(in, imported);
+    CHECK_EQ(list.size(), progress.books_parsed);
+    CHECK_EQ(list.size() - 1, progress.books_added);
+    CHECK_EQ(list.size() + 1, imported.size());
+    CHECK_EQ(Book("First", "Author", "isbn-first", 1), imported.at(0));
+    CHECK_EQ(list.at(0), imported.at(2));
+    CHECK_EQ(list.at(6), imported.at(7));
+  }
+
+  SUBCASE("ReportsProgressInOrder") {
+    std::vector<BookListImporter::Progress> reports;
+    BookListImporter importer(4, 500, 2);
+    importer.on_progress([&](const BookListImporter::Progress& progress) { reports.push_back(progress); });
+    std::istringstream in(text);
+    BookList imported(BookList::unbounded_capacity);
+    importer.import(in, imported);
+
+    REQUIRE(reports.size() > 10);
+    for (std::size_t report = 1; report < reports.size(); ++report) {
+      CHECK(reports[report - 1].bytes_read < reports[report].bytes_read);
+      CHECK(reports[report - 1].books_added <= reports[report].books_added);
+    }
+    CHECK_EQ(text.size(), reports.back().bytes_read);
+    CHECK_EQ(list.size(), reports.back().books_added);
+  }
+
+  SUBCASE("StopsAtCount") {
+    std::istringstream in("2\n\"a\",\"b\",\"c\",1\n\"d\",\"e\",\"f\",2\n\"g\",\"h\",\"i\",3\nnot a record\n");
+    BookList imported;
+    const BookListImporter::Progress progress = BookListImporter(2, 4).import(in, imported);
+    CHECK_EQ(BookList({Book("b", "c", "a", 1), Book("e", "f", "d", 2)}), imported);
+    CHECK_EQ(2U, progress.books_parsed);
+  }
+
+  SUBCASE("EmptyList") {
+    std::istringstream in("0\n");
+    BookList imported;
+    CHECK_EQ(0U, BookListImporter().import(in, imported).book_count);
+    CHECK_EQ(0U, imported.size());
+  }
+
+  SUBCASE("ReportsLineAndColumn") {
+    for (const std::size_t chunk_size : {3U, 1024U}) {
+      CHECK_EQ("1:1", error_at("", chunk_size));
+      CHECK_EQ("1:1", error_at("many\n", chunk_size));
+      CHECK_EQ("3:33", error_at("2\n    0:  \"a\",\"b\",\"c\",1\n    1:  \"isbn\",\"title\",\"author\",cheap\n",
+                                chunk_size));
+      CHECK_EQ("2:24", error_at("1\n    0:  \"isbn\",\"title\",\"author,1\n", chunk_size));
+      CHECK_EQ("3:1", error_at("2\n    0:  \"isbn\",\"title\",\"author\",1\n", chunk_size));
+      CHECK_EQ("no error", error_at("1\n\"isbn\",\"title\",\"author\",1\n\"bad", chunk_size));
+    }
+
+    // An error deep in the input names the line of the whole input, not of
+    // its chunk, as BookListParser does.
+    std::string damaged = text;
+    damaged.insert(damaged.find("isbn-150") - 1, "x");
+    try {
+      BookListParser(damaged).parse();
+      FAIL("expected a ParseError");
+    } catch (const BookListParser::ParseError& error) {
+      CHECK_EQ(2 + 3 * 150, error.line());
+      CHECK_EQ(std::to_string(error.line()) + ":" + std::to_string(error.column()), error_at(damaged, 64));
+    }
+  }
+
+  SUBCASE("KeepsBooksBeforeTheError") {
+    std::string damaged = text;
+    damaged.insert(damaged.find("isbn-190") - 1, "x");
+    std::istringstream in(damaged);
+    BookList imported(BookList::unbounded_capacity);
+    CHECK_THROWS_AS(BookListImporter(2, 64, 1).import(in, imported), BookListParser::ParseError);
+    CHECK(imported.size() <= 190);
+    CHECK(imported.size() > 150);
+    CHECK_EQ(list.at(imported.size() - 1), imported.at(imported.size() - 1));
+  }
+
+  SUBCASE("CapacityExceeded") {
+    if (BookList::stores_array) {
+      std::istringstream in(text);
+      BookList imported(10);
+      CHECK_THROWS_AS(BookListImporter(2, 64).import(in, imported), BookList::CapacityExceededException);
+      CHECK(imported.size() <= 10);
+    }
+  }
+
+  SUBCASE("ImportFile") {
+    BookList imported(BookList::unbounded_capacity);
+    {
+      const TemporaryPath temporary("book_list_importer_test", ".txt");
+      const std::string& path = temporary.string();
+      std::ofstream(path) << text;
+      BookListImporter().import_file(path, imported);
+      CHECK_EQ(list, imported);
+    }
+
+    const TemporaryPath missing("book_list_importer_test", ".missing");
+    CHECK_THROWS_AS(BookListImporter().import_file(missing.string(), imported), BookListImporter::ReadException);
+  }
+}
@@ -0,0 +1,362 @@
+#include "book_list_journal.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "binary_io.hpp"
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_snapshot.hpp"
+#include "mapped_file.hpp"
+
+namespace {
+  // The log starts with the magic, the format version, four reserved bytes
+  // and the checksum of the snapshot it extends. Each record after it is the
+  // length of its body, the body, and the FNV-1a hash of the body.
+  constexpr char magic[8] = {'B', 'O', 'O', 'K', 'L', 'O', 'G', '\0'};
+  constexpr std::size_t header_size = 24;
+  constexpr std::size_t framing_size = 4 + 8;
+
+  // Reads the fields of a record body in order, throwing FormatException if
+  // the body ends first.
+  class RecordReader {
+   public:
+    explicit RecordReader(std::string_view body) : body_(body) {}
+
+    unsigned char byte() {
+      return static_cast<unsigned char>(*take(1));
+    }
+
+    std::uint64_t u64() {
+      return binary_io::get_u64(take(8));
+    }
+
+    std::string_view string() {
+      const std::uint32_t length = binary_io::get_u32(take(4));
+      return std::string_view(take(length), length);
+    }
+
+    double price() {
+      const std::uint64_t bits = u64();
+      double price;
+      std::memcpy(&price, &bits, sizeof(price));
+      return price;
+    }
+
+    std::string_view rest() {
+      return body_.substr(std::exchange(position_, body_.size()));
+    }
+
+   private:
+    const char* take(std::size_t count) {
+      if (count > body_.size() - position_) {
+        throw BookListJournal::FormatException("Log record is shorter than its fields");
+      }
+      position_ += count;
+      return body_.data() + position_ - count;
+    }
+
+    std::string_view body_;
+    std::size_t position_ = 0;
+  };
+
+  void put_string(std::string& bytes, const std::string& text) {
+    binary_io::put_u32(bytes, static_cast<std::uint32_t>(text.size()));
+    bytes += text;
+  }
+
+  void put_price(std::string& bytes, double price) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &price, sizeof(bits));
+    binary_io::put_u64(bytes, bits);
+  }
+}
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookListJournal::BookListJournal(const std::string& snapshot_path,
+                                 const std::string& log_path,
+                                 std::size_t batch_size)
+    : snapshot_path_(snapshot_path),
+      log_path_(log_path),
+      batch_size_(batch_size == 0 ? 1 : batch_size) {
+  if (std::filesystem::exists(snapshot_path_)) {
+    const MappedFile snapshot(snapshot_path_);
+    books_ = BookListSnapshot::decode(snapshot.contents(), BookList::unbounded_capacity);
+    base_checksum_ = BookListSnapshot::checksum(snapshot.contents());
+  }
+
+  // A log missing, torn before its header was complete, or left over from an
+  // earlier snapshot starts over; otherwise new records follow the last
+  // complete one.
+  std::size_t log_length = 0;
+  if (std::filesystem::exists(log_path_)) {
+    const MappedFile log(log_path_);
+    log_length = replay(log.contents());
+  }
+
+  log_descriptor_ = ::open(log_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (log_descriptor_ == -1) {
+    throw WriteException("Cannot open the log " + log_path_ + ": " + std::strerror(errno));
+  }
+  try {
+    if (log_length == 0) {
+      restart_log();
+    } else if (::ftruncate(log_descriptor_, static_cast<off_t>(log_length)) == -1) {
+      throw WriteException("Cannot cut the torn tail from the log " + log_path_ + ": " + std::strerror(errno));
+    } else {
+      log_length_ = log_length;
+    }
+  } catch (...) {
+    ::close(log_descriptor_);
+    throw;
+  }
+}
+
+BookListJournal::~BookListJournal() noexcept {
+  try {
+    flush();
+  } catch (...) {
+  }
+  ::close(log_descriptor_);
+}
+
+//
+// Queries
+//
+
+const BookList& BookListJournal::books() const noexcept {
+  return books_;
+}
+
+std::size_t BookListJournal::pending() const noexcept {
+  return pending_;
+}
+
+std::size_t BookListJournal::replayed() const noexcept {
+  return replayed_;
+}
+
+//
+// Mutators
+//
+
+BookListJournal& BookListJournal::insert(const Book& book, BookList::Position position) {
+  return insert(book, position == BookList::Position::TOP ? 0 : books_.size());
+}
+
+BookListJournal& BookListJournal::insert(const Book& book, std::size_t offset_from_top) {
+  const std::size_t size_before = books_.size();
+  books_.insert(book, offset_from_top);
+  if (books_.size() != size_before) {
+    record_.clear();
+    record_ += static_cast<char>(Operation::INSERT);
+    binary_io::put_u64(record_, offset_from_top);
+    put_string(record_, book.isbn());
+    put_string(record_, book.title());
+    put_string(record_, book.author());
+    put_price(record_, book.price());
+    append_record();
+  }
+  return *this;
+}
+
+BookListJournal& BookListJournal::remove(const Book& book) {
+  return remove(books_.find(book));
+}
+
+BookListJournal& BookListJournal::remove(std::size_t offset_from_top) {
+  if (offset_from_top < books_.size()) {
+    books_.remove(offset_from_top);
+    record_.clear();
+    record_ += static_cast<char>(Operation::REMOVE);
+    binary_io::put_u64(record_, offset_from_top);
+    append_record();
+  }
+  return *this;
+}
+
+BookListJournal& BookListJournal::move_to_top(const Book& book) {
+  // A book that is missing or already at the top does not move.
+  const std::size_t offset_from_top = books_.find(book);
+  if (offset_from_top != books_.size() && offset_from_top != 0) {
+    books_.move_to_top(book);
+    record_.clear();
+    record_ += static_cast<char>(Operation::MOVE_TO_TOP);
+    binary_io::put_u64(record_, offset_from_top);
+    append_record();
+  }
+  return *this;
+}
+
+void BookListJournal::swap(BookList& other) {
+  books_.swap(other);
+  record_.clear();
+  record_ += static_cast<char>(Operation::REPLACE);
+  record_ += BookListSnapshot::encode(books_);
+  append_record();
+}
+
+//
+// Persistence
+//
+
+void BookListJournal::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  // Records written twice would be replayed twice, and records after a torn
+  // one would be cut with it, so the remains of a failed write go first.
+  if (log_torn_) {
+    if (::ftruncate(log_descriptor_, static_cast<off_t>(log_length_)) == -1) {
+      throw WriteException("Cannot cut a failed write from the log " + log_path_ + ": " + std::strerror(errno));
+    }
+    log_torn_ = false;
+  }
+  if (log_length_ == 0) {
+    restart_log();
+  }
+
+  try {
+    write_fully(buffer_);
+    if (::fsync(log_descriptor_) == -1) {
+      throw WriteException("Cannot sync the log " + log_path_ + ": " + std::strerror(errno));
+    }
+  } catch (...) {
+    // If the cut fails too, the next flush() tries it again.
+    log_torn_ = ::ftruncate(log_descriptor_, static_cast<off_t>(log_length_)) == -1;
+    throw;
+  }
+  log_length_ += buffer_.size();
+  buffer_.clear();
+  pending_ = 0;
+}
+
+void BookListJournal::checkpoint() {
+  flush();
+  base_checksum_ = BookListSnapshot::save(books_, snapshot_path_);
+  restart_log();
+}
+
+//
+// Log Records
+//
+
+std::size_t BookListJournal::replay(std::string_view log) {
+  if (log.size() < header_size) {
+    return 0;
+  }
+  if (std::memcmp(log.data(), magic, sizeof(magic)) != 0) {
+    throw FormatException("Not a BookList log: " + log_path_);
+  }
+  if (binary_io::get_u32(log.data() + 8) != version) {
+    throw FormatException("Unsupported log version " + std::to_string(binary_io::get_u32(log.data() + 8)));
+  }
+  if (binary_io::get_u64(log.data() + 16) != base_checksum_) {
+    return 0;
+  }
+
+  std::size_t position = header_size;
+  while (log.size() - position >= framing_size) {
+    const std::uint32_t length = binary_io::get_u32(log.data() + position);
+    if (length > log.size() - position - framing_size) {
+      break;
+    }
+    const std::string_view body = log.substr(position + 4, length);
+    if (binary_io::fnv1a(body) != binary_io::get_u64(log.data() + position + 4 + length)) {
+      break;
+    }
+
+    RecordReader reader(body);
+    const auto operation = static_cast<Operation>(reader.byte());
+    if (operation == Operation::INSERT) {
+      const std::size_t offset_from_top = reader.u64();
+      const std::string isbn(reader.string());
+      const std::string title(reader.string());
+      const std::string author(reader.string());
+      const std::size_t size_before = books_.size();
+      if (offset_from_top <= size_before) {
+        books_.insert(Book(title, author, isbn, reader.price()), offset_from_top);
+      }
+      if (books_.size() == size_before) {
+        throw FormatException("Log record " + std::to_string(replayed_) + " inserts a book that cannot be inserted");
+      }
+    } else if (operation == Operation::REMOVE || operation == Operation::MOVE_TO_TOP) {
+      const std::size_t offset_from_top = reader.u64();
+      if (offset_from_top >= books_.size()) {
+        throw FormatException("Log record " + std::to_string(replayed_) + " refers past the end of the list");
+      }
+      if (operation == Operation::REMOVE) {
+        books_.remove(offset_from_top);
+      } else {
+        const Book book = books_.at(offset_from_top);
+        books_.move_to_top(book);
+      }
+    } else if (operation == Operation::REPLACE) {
+      try {
+        books_ = BookListSnapshot::decode(reader.rest(), BookList::unbounded_capacity);
+      } catch (const BookListSnapshot::FormatException& error) {
+        throw FormatException("Log record " + std::to_string(replayed_) + " holds a bad list: " + error.what());
+      }
+    } else {
+      throw FormatException("Log record " + std::to_string(replayed_) + " has an unknown operation");
+    }
+
+    ++replayed_;
+    position += framing_size + length;
+  }
+  return position;
+}
+
+void BookListJournal::append_record() {
+  binary_io::put_u32(buffer_, static_cast<std::uint32_t>(record_.size()));
+  buffer_ += record_;
+  binary_io::put_u64(buffer_, binary_io::fnv1a(record_));
+  if (++pending_ >= batch_size_) {
+    flush();
+  }
+}
+
+void BookListJournal::restart_log() {
+  // Until the header is complete, flush() starts the log over rather than
+  // appending records to a log without one.
+  log_length_ = 0;
+  if (::ftruncate(log_descriptor_, 0) == -1) {
+    throw WriteException("Cannot empty the log " + log_path_ + ": " + std::strerror(errno));
+  }
+  log_torn_ = false;
+  std::string header(magic, sizeof(magic));
+  binary_io::put_u32(header, version);
+  binary_io::put_u32(header, 0);
+  binary_io::put_u64(header, base_checksum_);
+  write_fully(header);
+  if (::fsync(log_descriptor_) == -1) {
+    throw WriteException("Cannot sync the log " + log_path_ + ": " + std::strerror(errno));
+  }
+  log_length_ = header_size;
+}
+
+void BookListJournal::write_fully(const std::string& bytes) {
+  for (std::size_t written = 0; written < bytes.size();) {
+    const ssize_t result = ::write(log_descriptor_, bytes.data() + written, bytes.size() - written);
+    if (result == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw WriteException("Cannot write the log " + log_path_ + ": " + std::strerror(errno));
+    }
+    written += static_cast<std::size_t>(result);
+  }
+}
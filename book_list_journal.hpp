@@ -0,0 +1,163 @@
+#ifndef _book_list_journal_hpp_
+#define _book_list_journal_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The BookListJournal class keeps a BookList on disk as a BookListSnapshot
+// plus an append-only log of the changes made since the snapshot was taken,
+// so persisting a change costs a few bytes of I/O however long the list is.
+//
+// Each effective insert, remove, move_to_top and swap is encoded as a
+// compact, checksummed record and buffered. The buffered records are written
+// together, in one write followed by one fsync, once `batch_size` of them
+// have built up or when flush() is called. A change is durable once the
+// flush that writes it returns; changes that are still buffered when the
+// program dies are lost, but never half-applied.
+//
+// Opening a journal loads the snapshot and replays the log on top of it,
+// reproducing the list exactly. A record torn by a crash midway through a
+// write ends the replay, and is cut from the log before anything new is
+// appended. checkpoint() folds the log into a new snapshot. The log names
+// the snapshot it extends, so a log left over from before a checkpoint is
+// recognized and discarded rather than applied twice.
+class BookListJournal {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  struct FormatException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  struct WriteException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  // The format version of the log.
+  static constexpr std::uint32_t version = 1;
+
+  // The number of records buffered before they are written automatically.
+  static constexpr std::size_t default_batch_size = 64;
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor opens the journal kept in the files at `snapshot_path`
+  // and `log_path`, creating it empty if neither exists. The book list has
+  // unbounded capacity.
+  //
+  // Throws BookListSnapshot::FormatException if the snapshot is damaged,
+  // FormatException if the log has a bad header or a record that does not
+  // apply to the list, and WriteException if the log cannot be opened.
+  BookListJournal(const std::string& snapshot_path,
+                  const std::string& log_path,
+                  std::size_t batch_size = default_batch_size);
+
+  // A journal owns its log file, so it can be neither copied nor moved.
+  BookListJournal(const BookListJournal& other) = delete;
+  BookListJournal& operator=(const BookListJournal& rhs) = delete;
+
+  // The destructor flushes the buffered records, ignoring any error since a
+  // destructor cannot report it. Call flush() first to find out.
+  ~BookListJournal() noexcept;
+
+  //
+  // Queries
+  //
+
+  // Returns the book list.
+  const BookList& books() const noexcept;
+
+  // Returns the number of records buffered but not yet written.
+  std::size_t pending() const noexcept;
+
+  // Returns the number of log records replayed when the journal was opened.
+  std::size_t replayed() const noexcept;
+
+  //
+  // Mutators
+  //
+
+  // These apply the change to the book list as the BookList methods of the
+  // same name do, and record it if it changed the list.
+  BookListJournal& insert(const Book& book, BookList::Position position = BookList::Position::TOP);
+  BookListJournal& insert(const Book& book, std::size_t offset_from_top);
+  BookListJournal& remove(const Book& book);
+  BookListJournal& remove(std::size_t offset_from_top);
+  BookListJournal& move_to_top(const Book& book);
+
+  // Swaps the book list with `other`. The record holds the whole new list, so
+  // this costs as much I/O as a snapshot of it.
+  void swap(BookList& other);
+
+  //
+  // Persistence
+  //
+
+  // Writes the buffered records to the log and waits for them to reach the
+  // disk. Throws WriteException if they cannot be written, keeping them
+  // buffered and cutting whatever part of them reached the log, so a later
+  // flush() writes each record exactly once.
+  void flush();
+
+  // Writes a snapshot of the book list and starts an empty log on it. Throws
+  // BookListSnapshot::WriteException if the snapshot cannot be written, and
+  // WriteException if the log cannot.
+  void checkpoint();
+
+ private:
+  // The kinds of log records.
+  enum class Operation : unsigned char {INSERT = 1, REMOVE, MOVE_TO_TOP, REPLACE};
+
+  // Replays the records in the log image on top of books_, and returns the
+  // length of the prefix holding complete records.
+  std::size_t replay(std::string_view log);
+
+  // Frames the record body in record_ and adds it to the buffer.
+  void append_record();
+
+  // Empties the log and writes a header naming the current snapshot.
+  void restart_log();
+
+  // Writes all of `bytes` to the log file.
+  void write_fully(const std::string& bytes);
+
+  std::string snapshot_path_;
+  std::string log_path_;
+  std::size_t batch_size_;
+
+  // The book list, with every change applied whether flushed or not.
+  BookList books_{BookList::unbounded_capacity};
+
+  // The checksum of the snapshot the log extends, or zero if there is none.
+  std::uint64_t base_checksum_ = 0;
+
+  // The log file, opened for appending.
+  int log_descriptor_ = -1;
+
+  // The length of the log's header and complete records, or zero if the
+  // header is missing. Whatever a failed write left past it is cut before
+  // anything else is written, and `log_torn_` is set until it has been.
+  std::size_t log_length_ = 0;
+  bool log_torn_ = false;
+
+  // The framed records not yet written, and how many there are.
+  std::string buffer_;
+  std::size_t pending_ = 0;
+
+  // The body of the record being built, reused from record to record.
+  std::string record_;
+
+  std::size_t replayed_ = 0;
+};
+
+#endif
@@ -0,0 +1,186 @@
+// Unit tests for the BookListJournal class.
+
+#include <csignal>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <sys/resource.h>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_journal.hpp"
+#include "doctest.hpp"
+#include "temporary_path.hpp"
+
+TEST_CASE("BookListJournal") {
+  const TemporaryPath snapshot_file("book_list_journal_test", ".snapshot");
+  const TemporaryPath log_file("book_list_journal_test", ".log");
+  const std::string& snapshot_path = snapshot_file.string();
+  const std::string& log_path = log_file.string();
+
+  const Book book_1("title_1", "author", "isbn_1", 1.0),
+      book_2("title_2", "author", "isbn_2", 2.0),
+      book_3("title_3", "author", "isbn_3", 3.0),
+      book_4("title_4", "author", "isbn_4", 4.0);
+
+  SUBCASE("StartsEmpty") {
+    BookListJournal journal(snapshot_path, log_path);
+    CHECK_EQ(BookList(), journal.books());
+    CHECK_EQ(0U, journal.replayed());
+  }
+
+  SUBCASE("ReplayReproducesList") {
+    BookList expected;
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      journal.insert(book_1)
+          .insert(book_2, BookList::Position::BOTTOM)
+          .insert(book_3, 1)
+          .insert(book_4)
+          .move_to_top(book_2)
+          .remove(book_1)
+          .remove(std::size_t{1});
+      expected = journal.books();
+      CHECK_EQ(7U, journal.pending());
+    }
+    BookListJournal reopened(snapshot_path, log_path);
+    CHECK_EQ(expected, reopened.books());
+    CHECK_EQ(7U, reopened.replayed());
+  }
+
+  SUBCASE("RecordsOnlyEffectiveChanges") {
+    BookListJournal journal(snapshot_path, log_path);
+    journal.insert(book_1).insert(book_1).remove(book_2).remove(5).move_to_top(book_1).move_to_top(book_3);
+    CHECK_EQ(1U, journal.pending());
+  }
+
+  SUBCASE("FlushesInBatches") {
+    BookListJournal journal(snapshot_path, log_path, 3);
+    const auto log_size = [&] { return std::filesystem::file_size(log_path); };
+    const auto empty_size = log_size();
+
+    journal.insert(book_1).insert(book_2);
+    CHECK_EQ(2U, journal.pending());
+    CHECK_EQ(empty_size, log_size());
+
+    journal.insert(book_3);
+    CHECK_EQ(0U, journal.pending());
+    CHECK_LT(empty_size, log_size());
+
+    journal.insert(book_4);
+    journal.flush();
+    CHECK_EQ(0U, journal.pending());
+    CHECK_EQ(4U, BookListJournal(snapshot_path, log_path).books().size());
+  }
+
+  SUBCASE("ChangeCostsConstantIo") {
+    BookListJournal journal(snapshot_path, log_path);
+    for (int i = 0; i < 500; ++i) {
+      journal.insert(Book("Title-" + std::to_string(i), "Author", "isbn-" + std::to_string(i)));
+    }
+    journal.checkpoint();
+    const auto before = std::filesystem::file_size(log_path);
+    journal.remove(std::size_t{250});
+    journal.flush();
+    CHECK_EQ(before + 4 + 9 + 8, std::filesystem::file_size(log_path));
+  }
+
+  SUBCASE("Swap") {
+    BookList other({book_3, book_4});
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      journal.insert(book_1);
+      journal.swap(other);
+      journal.insert(book_2, BookList::Position::BOTTOM);
+    }
+    CHECK_EQ(BookList({book_1}), other);
+    CHECK_EQ(BookList({book_3, book_4, book_2}), BookListJournal(snapshot_path, log_path).books());
+  }
+
+  SUBCASE("CheckpointFoldsLogIntoSnapshot") {
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      journal.insert(book_1).insert(book_2);
+      journal.checkpoint();
+      journal.insert(book_3);
+    }
+    BookListJournal reopened(snapshot_path, log_path);
+    CHECK_EQ(BookList({book_3, book_2, book_1}), reopened.books());
+    CHECK_EQ(1U, reopened.replayed());
+  }
+
+  SUBCASE("DiscardsLogFromBeforeCheckpoint") {
+    // A crash after the snapshot is replaced but before the log is restarted
+    // leaves the old log behind. It must not be applied to the new snapshot.
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      journal.insert(book_1).insert(book_2);
+    }
+    const std::string stale_log = log_path + ".stale";
+    std::filesystem::copy_file(log_path, stale_log);
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      journal.checkpoint();
+    }
+    std::filesystem::rename(stale_log, log_path);
+
+    BookListJournal reopened(snapshot_path, log_path);
+    CHECK_EQ(BookList({book_2, book_1}), reopened.books());
+    CHECK_EQ(0U, reopened.replayed());
+  }
+
+  SUBCASE("IgnoresTornRecord") {
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      journal.insert(book_1).insert(book_2);
+    }
+    const auto complete_size = std::filesystem::file_size(log_path);
+    std::filesystem::resize_file(log_path, complete_size - 3);
+    {
+      BookListJournal journal(snapshot_path, log_path);
+      CHECK_EQ(BookList({book_1}), journal.books());
+      CHECK_EQ(1U, journal.replayed());
+      journal.insert(book_3);
+    }
+    CHECK_EQ(BookList({book_3, book_1}), BookListJournal(snapshot_path, log_path).books());
+  }
+
+  SUBCASE("RetriesFailedWrite") {
+    BookList expected;
+    {
+      BookListJournal journal(snapshot_path, log_path, 100);
+      journal.insert(book_1);
+      journal.flush();
+      const auto flushed_size = std::filesystem::file_size(log_path);
+      journal.insert(book_2).insert(book_3).move_to_top(book_1);
+
+      // A file size limit stops the write partway through the batch, as a
+      // full disk would.
+      rlimit original;
+      REQUIRE_EQ(0, ::getrlimit(RLIMIT_FSIZE, &original));
+      rlimit limited = original;
+      limited.rlim_cur = static_cast<rlim_t>(flushed_size + 10);
+      const auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+      REQUIRE_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limited));
+      CHECK_THROWS_AS(journal.flush(), BookListJournal::WriteException);
+      ::setrlimit(RLIMIT_FSIZE, &original);
+      std::signal(SIGXFSZ, previous_handler);
+
+      CHECK_EQ(flushed_size, std::filesystem::file_size(log_path));
+      CHECK_EQ(3U, journal.pending());
+      journal.flush();
+      expected = journal.books();
+    }
+    BookListJournal reopened(snapshot_path, log_path);
+    CHECK_EQ(expected, reopened.books());
+    CHECK_EQ(BookList({book_1, book_3, book_2}), reopened.books());
+    CHECK_EQ(4U, reopened.replayed());
+  }
+
+  SUBCASE("RejectsForeignLog") {
+    std::ofstream(log_path) << "not a log, but long enough to have a header";
+    CHECK_THROWS_AS(BookListJournal(snapshot_path, log_path), BookListJournal::FormatException);
+  }
+}
@@ -0,0 +1,243 @@
+#include "book_list_parser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "mapped_file.hpp"
+
+namespace {
+  // The length of the shortest possible record, "","","",0 and a newline.
+  constexpr std::size_t shortest_record = 11;
+}
+
+//
+// Parse Errors
+//
+
+BookListParser::ParseError::ParseError(const std::string& message, std::size_t line, std::size_t column)
+    : std::runtime_error("line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message),
+      line_(line),
+      column_(column) {}
+
+std::size_t BookListParser::ParseError::line() const noexcept {
+  return line_;
+}
+
+std::size_t BookListParser::ParseError::column() const noexcept {
+  return column_;
+}
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+BookListParser::BookListParser(std::string_view text) : text_(text) {
+  skip_whitespace(true);
+  count_ = read_count("the book count");
+}
+
+BookListParser::BookListParser(std::string_view records, std::size_t first_line, std::size_t limit) noexcept
+    : text_(records), line_(first_line), count_(limit) {}
+
+//
+// Queries
+//
+
+std::size_t BookListParser::count() const noexcept {
+  return count_;
+}
+
+std::size_t BookListParser::parsed() const noexcept {
+  return parsed_;
+}
+
+std::size_t BookListParser::position() const noexcept {
+  return position_;
+}
+
+//
+// Parsing
+//
+
+bool BookListParser::next(Book& book) {
+  if (parsed_ == count_) {
+    return false;
+  }
+
+  skip_whitespace(true);
+  if (position_ == text_.size()) {
+    fail("expected " + std::to_string(count_) + " books but found " + std::to_string(parsed_));
+  }
+
+  // The row number operator<< writes before each record is optional, and its
+  // value is not checked.
+  if (text_[position_] >= '0' && text_[position_] <= '9') {
+    read_count("a row number");
+    skip_whitespace(false);
+    expect(':', "':' after the row number");
+    skip_whitespace(false);
+  }
+
+  const std::string_view isbn = read_quoted(isbn_, "ISBN");
+  skip_whitespace(false);
+  expect(',', "',' after the ISBN");
+  skip_whitespace(false);
+  const std::string_view title = read_quoted(title_, "title");
+  skip_whitespace(false);
+  expect(',', "',' after the title");
+  skip_whitespace(false);
+  const std::string_view author = read_quoted(author_, "author");
+  skip_whitespace(false);
+  expect(',', "',' after the author");
+  skip_whitespace(false);
+  const double price = read_price();
+
+  skip_whitespace(false);
+  if (position_ < text_.size() && text_[position_] == '\r') {
+    ++position_;
+  }
+  if (position_ < text_.size() && text_[position_] != '\n') {
+    fail("unexpected text after the price");
+  }
+
+  book = Book(title, author, isbn, price);
+  ++parsed_;
+  return true;
+}
+
+std::vector<Book> BookListParser::parse() {
+  // Trust the count only as far as the text could hold that many records, so
+  // a corrupt count cannot force a huge allocation.
+  std::vector<Book> books;
+  books.reserve(std::min(count_ - parsed_, (text_.size() - position_) / shortest_record + 1));
+  for (Book book; next(book);) {
+    books.push_back(std::move(book));
+  }
+  return books;
+}
+
+BookList& BookListParser::parse_into(BookList& book_list) {
+  std::vector<Book> books = parse();
+  return book_list.append(std::make_move_iterator(books.begin()), std::make_move_iterator(books.end()));
+}
+
+std::vector<Book> BookListParser::parse_records(std::string_view records, std::size_t first_line,
+                                                std::size_t limit) {
+  // The slice ends after its last record, or in whitespace after it, rather
+  // than short of a count.
+  BookListParser parser(records, first_line, limit);
+  std::vector<Book> books;
+  books.reserve(std::min(limit, records.size() / shortest_record + 1));
+  for (Book book;; books.push_back(std::move(book))) {
+    parser.skip_whitespace(true);
+    if (parser.position_ == parser.text_.size() || !parser.next(book)) {
+      break;
+    }
+  }
+  return books;
+}
+
+BookList BookListParser::load_file(const std::string& path, std::size_t capacity) {
+  const MappedFile file(path);
+  BookList book_list(capacity);
+  BookListParser(file.contents()).parse_into(book_list);
+  return book_list;
+}
+
+//
+// Tokenizing
+//
+
+void BookListParser::fail(const std::string& message) const {
+  throw ParseError(message, line_, position_ - line_start_ + 1);
+}
+
+void BookListParser::skip_whitespace(bool newlines) {
+  for (; position_ < text_.size(); ++position_) {
+    const char c = text_[position_];
+    if (c == '\n' && newlines) {
+      ++line_;
+      line_start_ = position_ + 1;
+    } else if (c != ' ' && c != '\t' && !(c == '\r' && newlines)) {
+      break;
+    }
+  }
+}
+
+void BookListParser::expect(char expected, const char* what) {
+  if (position_ == text_.size() || text_[position_] != expected) {
+    fail(std::string("expected ") + what);
+  }
+  ++position_;
+}
+
+std::size_t BookListParser::read_count(const char* what) {
+  std::size_t value = 0;
+  const char* first = text_.data() + position_;
+  const auto [last, error] = std::from_chars(first, text_.data() + text_.size(), value);
+  if (error != std::errc()) {
+    fail(std::string("expected ") + what);
+  }
+  position_ += static_cast<std::size_t>(last - first);
+  return value;
+}
+
+std::string_view BookListParser::read_quoted(std::string& field, const char* name) {
+  if (position_ == text_.size() || text_[position_] != '"') {
+    fail(std::string("expected the quoted ") + name);
+  }
+  ++position_;
+  const std::size_t opening_line = line_;
+  const std::size_t opening_column = position_ - line_start_;
+
+  // A field without escapes is returned as a view of the text. Otherwise the
+  // runs between escapes are copied into `field` in one piece each, rather
+  // than a character at a time.
+  const std::size_t field_start = position_;
+  bool escaped = false;
+  std::size_t run_start = position_;
+  for (; position_ < text_.size(); ++position_) {
+    const char c = text_[position_];
+    if (c == '"') {
+      ++position_;
+      if (!escaped) {
+        return text_.substr(field_start, position_ - 1 - field_start);
+      }
+      field.append(text_, run_start, position_ - 1 - run_start);
+      return field;
+    }
+    if (c == '\\' && position_ + 1 < text_.size()) {
+      if (!escaped) {
+        field.clear();
+        escaped = true;
+      }
+      field.append(text_, run_start, position_ - run_start);
+      run_start = ++position_;
+    }
+    if (text_[position_] == '\n') {
+      ++line_;
+      line_start_ = position_ + 1;
+    }
+  }
+  throw ParseError(std::string("unterminated ") + name, opening_line, opening_column);
+}
+
+double BookListParser::read_price() {
+  double price = 0.0;
+  const char* first = text_.data() + position_;
+  const auto [last, error] = std::from_chars(first, text_.data() + text_.size(), price);
+  if (error != std::errc()) {
+    fail("expected the price");
+  }
+  position_ += static_cast<std::size_t>(last - first);
+  return price;
+}
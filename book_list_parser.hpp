@@ -0,0 +1,150 @@
+#ifndef _book_list_parser_hpp_
+#define _book_list_parser_hpp_
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The BookListParser class reads the text format operator<< writes for a
+// BookList straight out of a contiguous buffer, such as a MappedFile:
+//
+//   2
+//       0:  "9780064430173","Goodnight Moon","Margaret Wise Brown",8.99
+//       1:  "9780060256654","The Giving Tree","Shel Silverstein",12.5
+//
+// Each record is tokenized in a single pass over the buffer and its price
+// parsed with std::from_chars, so nothing goes through a stream. Each book is
+// built as soon as its record is read, straight from views of the buffer, so
+// a field is copied only into the book. Only fields with backslash escapes
+// are first unescaped into scratch strings reused from record to record.
+//
+// Whitespace around row numbers, fields and commas is ignored, as
+// operator>> ignores it. Malformed or truncated input throws ParseError
+// naming the line and column where the parser gave up.
+class BookListParser {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  struct ParseError : std::runtime_error {
+    // Constructs an error for the 1-based `line` and `column` of the input.
+    ParseError(const std::string& message, std::size_t line, std::size_t column);
+
+    std::size_t line() const noexcept;
+    std::size_t column() const noexcept;
+
+   private:
+    std::size_t line_;
+    std::size_t column_;
+  };
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor prepares to parse `text`, which must outlive the parser,
+  // and reads the book count at its start. Throws ParseError if the text does
+  // not start with a count.
+  explicit BookListParser(std::string_view text);
+
+  //
+  // Queries
+  //
+
+  // Returns the number of books the text says it holds.
+  std::size_t count() const noexcept;
+
+  // Returns the number of books parsed so far.
+  std::size_t parsed() const noexcept;
+
+  // Returns the offset in the text of the next character to read. Just after
+  // construction, that is the end of the book count.
+  std::size_t position() const noexcept;
+
+  //
+  // Parsing
+  //
+
+  // Parses the next record into `book` and returns true, or returns false
+  // once count() records have been parsed, leaving `book` untouched.
+  //
+  // Throws ParseError if the record is malformed or the text ends first.
+  bool next(Book& book);
+
+  // Parses every remaining record and returns the books in order.
+  std::vector<Book> parse();
+
+  // Parses every remaining record and adds the books to the bottom of
+  // `book_list` in one batch, as BookList::append() does. Nothing is added if
+  // the text is malformed.
+  BookList& parse_into(BookList& book_list);
+
+  // Parses the records in `records`, which holds whole records but no book
+  // count, such as a slice of a larger text cut between two records, and
+  // returns the books in order. Parsing stops after `limit` records, or where
+  // the slice ends. Errors name lines counted from `first_line`, the line of
+  // the larger text the slice starts on.
+  //
+  // Throws ParseError if a record before the limit is malformed.
+  static std::vector<Book> parse_records(std::string_view records, std::size_t first_line = 1,
+                                         std::size_t limit = std::numeric_limits<std::size_t>::max());
+
+  // Maps the file at `path` into memory and returns the book list it holds,
+  // with room for `capacity` books.
+  //
+  // Throws MappedFile::OpenException if the file cannot be read, and
+  // ParseError if it is malformed.
+  static BookList load_file(const std::string& path, std::size_t capacity = BookList::unbounded_capacity);
+
+ private:
+  // This constructor prepares to parse up to `limit` of `records`, which
+  // start on line `first_line` and hold no book count.
+  BookListParser(std::string_view records, std::size_t first_line, std::size_t limit) noexcept;
+
+  // Throws a ParseError for the current position.
+  [[noreturn]] void fail(const std::string& message) const;
+
+  // Skips spaces and tabs, and newlines too when `newlines` is true.
+  void skip_whitespace(bool newlines);
+
+  // Consumes `expected` or throws a ParseError describing `what` was missing.
+  void expect(char expected, const char* what);
+
+  // Reads an unsigned decimal integer.
+  std::size_t read_count(const char* what);
+
+  // Reads the double-quoted field called `name` and returns its text: a view
+  // of the text being parsed, or if the field holds std::quoted's backslash
+  // escapes, of `field`, into which it is unescaped.
+  std::string_view read_quoted(std::string& field, const char* name);
+
+  // Reads the price at the end of a record.
+  double read_price();
+
+  // The text being parsed, and the offset of the next character to read.
+  std::string_view text_;
+  std::size_t position_ = 0;
+
+  // The 1-based line of position_, and the offset at which that line starts.
+  std::size_t line_ = 1;
+  std::size_t line_start_ = 0;
+
+  // The count read from the start of the text, and how many books followed.
+  std::size_t count_ = 0;
+  std::size_t parsed_ = 0;
+
+  // The unescaped text of fields with escapes. Reused from record to record,
+  // so parsing allocates only while they grow.
+  std::string isbn_;
+  std::string title_;
+  std::string author_;
+};
+
+#endif
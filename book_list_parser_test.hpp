@@ -0,0 +1,148 @@
+// Unit tests for the BookListParser and MappedFile classes.
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_parser.hpp"
+#include "doctest.hpp"
+#include "mapped_file.hpp"
+#include "temporary_path.hpp"
+
+TEST_CASE("BookListParser") {
+  SUBCASE("ReadsWhatOperatorInsertionWrites") {
+    BookList list(BookList::unbounded_capacity);
+    list += {
+        Book("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99),
+        Book("A \"quoted\" title", "Back\\slash", "123", 1e-7),
+        Book("", "", "", 0.0),
+        Book("Negative", "Price", "000", -2.5)
+    };
+    for (int i = 0; i < 20; ++i) {
+      list.insert(Book("Book-" + std::to_string(i), "Author", std::to_string(i), i + 0.25),
+                  BookList::Position::BOTTOM);
+    }
+    std::ostringstream stream;
+    stream << list;
+
+    const std::string text = stream.str();
+
+    BookListParser parser(text);
+    CHECK_EQ(list.size(), parser.count());
+    BookList parsed(BookList::unbounded_capacity);
+    parser.parse_into(parsed);
+    CHECK_EQ(list, parsed);
+    CHECK_EQ(list.size(), parser.parsed());
+  }
+
+  SUBCASE("AcceptsWhatOperatorExtractionAccepts") {
+    BookListParser parser("3\n 0:  \"123\", \"A\", \"B\", 1\n 1:\"456\",\"D\",\"E\",2\r\n\"789\" , \"G\" , \"H\" , 3");
+    CHECK_EQ(std::vector<Book>{Book("A", "B", "123", 1), Book("D", "E", "456", 2), Book("G", "H", "789", 3)},
+             parser.parse());
+  }
+
+  SUBCASE("NextStopsAfterCount") {
+    BookListParser parser("1\n    0:  \"isbn\",\"title\",\"author\",1\n    1:  \"extra\",\"\",\"\",2\n");
+    Book book;
+    CHECK(parser.next(book));
+    CHECK_EQ(Book("title", "author", "isbn", 1), book);
+    CHECK_FALSE(parser.next(book));
+    CHECK_EQ(Book("title", "author", "isbn", 1), book);
+  }
+
+  SUBCASE("EmptyList") {
+    BookListParser parser("0\n");
+    CHECK_EQ(0U, parser.count());
+    CHECK(parser.parse().empty());
+  }
+
+  SUBCASE("ReportsLineAndColumn") {
+    const auto error_at = [](const std::string& text) {
+      try {
+        BookListParser(text).parse();
+      } catch (const BookListParser::ParseError& error) {
+        return std::to_string(error.line()) + ":" + std::to_string(error.column());
+      }
+      return std::string("no error");
+    };
+
+    CHECK_EQ("1:1", error_at(""));
+    CHECK_EQ("1:1", error_at("many\n"));
+    CHECK_EQ("2:6", error_at("1\n    0;  \"isbn\",\"title\",\"author\",1\n"));
+    CHECK_EQ("2:9", error_at("1\n    0:  isbn,\"title\",\"author\",1\n"));
+    CHECK_EQ("2:16", error_at("1\n    0:  \"isbn\" \"title\",\"author\",1\n"));
+    CHECK_EQ("3:33", error_at("2\n    0:  \"a\",\"b\",\"c\",1\n    1:  \"isbn\",\"title\",\"author\",cheap\n"));
+    CHECK_EQ("2:35", error_at("1\n    0:  \"isbn\",\"title\",\"author\",1 2\n"));
+    CHECK_EQ("2:24", error_at("1\n    0:  \"isbn\",\"title\",\"author,1\n"));
+    CHECK_EQ("3:1", error_at("2\n    0:  \"isbn\",\"title\",\"author\",1\n"));
+  }
+
+  SUBCASE("ErrorMessageNamesPosition") {
+    try {
+      BookListParser("1\n    0:  \"isbn\",\"title\",\"author\"\n").parse();
+      FAIL("expected a ParseError");
+    } catch (const BookListParser::ParseError& error) {
+      CHECK_EQ(std::string("line 2, column 32: expected ',' after the author"), error.what());
+    }
+  }
+
+  SUBCASE("CorruptCountDoesNotReserve") {
+    CHECK_THROWS_AS(BookListParser("18446744073709551615\n").parse(), BookListParser::ParseError);
+  }
+
+  SUBCASE("ParseRecords") {
+    const std::string records = "\n    7:  \"123\",\"A\",\"B\",1\n\"456\",\"D\",\"E\",2\n  \n";
+    CHECK_EQ(std::vector<Book>{Book("A", "B", "123", 1), Book("D", "E", "456", 2)},
+             BookListParser::parse_records(records));
+    CHECK_EQ(std::vector<Book>{Book("A", "B", "123", 1)}, BookListParser::parse_records(records + "junk", 1, 1));
+    CHECK(BookListParser::parse_records("").empty());
+    try {
+      BookListParser::parse_records(records + "junk", 40);
+      FAIL("expected a ParseError");
+    } catch (const BookListParser::ParseError& error) {
+      CHECK_EQ(44U, error.line());
+      CHECK_EQ(1U, error.column());
+    }
+  }
+
+  SUBCASE("MalformedInputAddsNothing") {
+    BookList list;
+    CHECK_THROWS_AS(BookListParser("2\n 0: \"a\",\"b\",\"c\",1\n").parse_into(list), BookListParser::ParseError);
+    CHECK_EQ(0U, list.size());
+  }
+}
+
+TEST_CASE("LoadFile") {
+  const TemporaryPath temporary("book_list_parser_test", ".txt");
+  const std::string& path = temporary.string();
+
+  SUBCASE("RoundTrip") {
+    BookList list(BookList::unbounded_capacity);
+    for (int i = 0; i < 100; ++i) {
+      list.insert(Book("Title-" + std::to_string(i), "Author", "isbn-" + std::to_string(i), i / 4.0),
+                  BookList::Position::BOTTOM);
+    }
+    {
+      std::ofstream file(path);
+      std::string buffer;
+      file << list.write_to(buffer);
+    }
+    CHECK_EQ(list, BookListParser::load_file(path));
+    if (BookList::stores_array) {
+      CHECK_THROWS_AS(BookListParser::load_file(path, 10), BookList::CapacityExceededException);
+    }
+  }
+
+  SUBCASE("EmptyFile") {
+    std::ofstream(path).close();
+    CHECK_EQ(0U, MappedFile(path).size());
+    CHECK_THROWS_AS(BookListParser::load_file(path), BookListParser::ParseError);
+  }
+
+  SUBCASE("MissingFile") {
+    CHECK_THROWS_AS(MappedFile(path + ".missing"), MappedFile::OpenException);
+  }
+}
@@ -0,0 +1,202 @@
+#include "book_list_snapshot.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_io.hpp"
+#include "book.hpp"
+#include "book_list.hpp"
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+  constexpr char magic[8] = {'B', 'O', 'O', 'K', 'L', 'I', 'S', 'T'};
+  constexpr std::size_t header_size = 40;
+  constexpr std::size_t record_size = 24;
+}
+
+//
+// Saving and Loading
+//
+
+std::string BookListSnapshot::encode(const BookList& book_list) {
+  if (!book_list.containers_are_consistent()) {
+    throw BookList::InvalidInternalStateException(
+        "Container consistency error in BookListSnapshot::encode");
+  }
+
+  // Lay out the string table first, storing each distinct string once. The
+  // keys view the books' own strings, which outlive the map.
+  std::string strings;
+  std::unordered_map<std::string_view, std::uint32_t> offsets;
+  const auto offset_of = [&](const std::string& text) {
+    const auto [position, inserted] = offsets.emplace(text, static_cast<std::uint32_t>(strings.size()));
+    if (inserted) {
+      if (strings.size() + 4 + text.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw FormatException("String table exceeds 4 GiB in BookListSnapshot::encode");
+      }
+      binary_io::put_u32(strings, static_cast<std::uint32_t>(text.size()));
+      strings += text;
+    }
+    return position->second;
+  };
+
+  const std::size_t count = book_list.size_unchecked();
+  std::string image;
+  image.reserve(header_size + count * record_size);
+  image.append(magic, sizeof(magic));
+  binary_io::put_u32(image, version);
+  binary_io::put_u32(image, 0);
+  binary_io::put_u64(image, count);
+  binary_io::put_u64(image, 0);
+  binary_io::put_u64(image, 0);
+
+  for (auto position = book_list.primary_begin(); position != book_list.primary_end(); ++position) {
+    std::uint64_t price_bits;
+    const double price = position->price();
+    std::memcpy(&price_bits, &price, sizeof(price_bits));
+
+    binary_io::put_u32(image, offset_of(position->isbn()));
+    binary_io::put_u32(image, offset_of(position->title()));
+    binary_io::put_u32(image, offset_of(position->author()));
+    binary_io::put_u32(image, 0);
+    binary_io::put_u64(image, price_bits);
+  }
+  image += strings;
+
+  binary_io::patch_u64(image, 24, strings.size());
+  binary_io::patch_u64(image, 32, binary_io::fnv1a(std::string_view(image).substr(header_size)));
+  return image;
+}
+
+BookList BookListSnapshot::decode(std::string_view image, std::size_t capacity) {
+  if (image.size() < header_size) {
+    throw FormatException("Snapshot is truncated: no complete header");
+  }
+  if (std::memcmp(image.data(), magic, sizeof(magic)) != 0) {
+    throw FormatException("Not a BookList snapshot");
+  }
+  if (binary_io::get_u32(image.data() + 8) != version) {
+    throw FormatException("Unsupported snapshot version "
+                          + std::to_string(binary_io::get_u32(image.data() + 8)));
+  }
+
+  // Check the sizes add up before trusting them, guarding the arithmetic
+  // against counts too large to be real.
+  const std::uint64_t count = binary_io::get_u64(image.data() + 16);
+  const std::uint64_t strings_size = binary_io::get_u64(image.data() + 24);
+  const std::size_t body_size = image.size() - header_size;
+  if (count > body_size / record_size || strings_size != body_size - count * record_size) {
+    throw FormatException("Snapshot is truncated or has trailing bytes");
+  }
+  if (binary_io::fnv1a(image.substr(header_size)) != binary_io::get_u64(image.data() + 32)) {
+    throw FormatException("Snapshot checksum mismatch");
+  }
+
+  const std::string_view strings = image.substr(header_size + count * record_size);
+  const auto string_at = [&strings](std::uint32_t offset) {
+    if (strings.size() < 4 || offset > strings.size() - 4
+        || binary_io::get_u32(strings.data() + offset) > strings.size() - 4 - offset) {
+      throw FormatException("Snapshot record refers past the string table");
+    }
+    return strings.substr(offset + 4, binary_io::get_u32(strings.data() + offset));
+  };
+
+  std::vector<Book> books;
+  books.reserve(count);
+  for (const char* record = image.data() + header_size; books.size() != count; record += record_size) {
+    const std::string_view isbn = string_at(binary_io::get_u32(record));
+    const std::string_view title = string_at(binary_io::get_u32(record + 4));
+    const std::string_view author = string_at(binary_io::get_u32(record + 8));
+
+    const std::uint64_t price_bits = binary_io::get_u64(record + 16);
+    double price;
+    std::memcpy(&price, &price_bits, sizeof(price));
+
+    books.emplace_back(title, author, isbn, price);
+  }
+
+  BookList book_list(capacity);
+  book_list.append(std::make_move_iterator(books.begin()), std::make_move_iterator(books.end()));
+  return book_list;
+}
+
+std::uint64_t BookListSnapshot::checksum(std::string_view image) {
+  if (image.size() < header_size) {
+    throw FormatException("Snapshot is truncated: no complete header");
+  }
+  return binary_io::get_u64(image.data() + 32);
+}
+
+std::uint64_t BookListSnapshot::save(const BookList& book_list, const std::string& path) {
+  const std::string image = encode(book_list);
+  const std::string temporary_path = path + ".tmp";
+
+  // The temporary file reaches the disk before it replaces `path`, and the
+  // rename reaches it before save() returns, so a caller may drop whatever
+  // the snapshot supersedes as soon as it does.
+  const int descriptor = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (descriptor == -1) {
+    throw WriteException("Cannot create the snapshot " + temporary_path + ": " + std::strerror(errno));
+  }
+  const char* failed = nullptr;
+  int error = 0;
+  for (std::size_t written = 0; written < image.size() && failed == nullptr;) {
+    const ssize_t result = ::write(descriptor, image.data() + written, image.size() - written);
+    if (result != -1) {
+      written += static_cast<std::size_t>(result);
+    } else if (errno != EINTR) {
+      failed = "write";
+      error = errno;
+    }
+  }
+  if (failed == nullptr && ::fsync(descriptor) == -1) {
+    failed = "sync";
+    error = errno;
+  }
+  if (::close(descriptor) == -1 && failed == nullptr) {
+    failed = "close";
+    error = errno;
+  }
+  if (failed != nullptr) {
+    std::remove(temporary_path.c_str());
+    throw WriteException(std::string("Cannot ") + failed + " the snapshot " + temporary_path + ": " +
+                         std::strerror(error));
+  }
+
+  if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    const int rename_error = errno;
+    std::remove(temporary_path.c_str());
+    throw WriteException("Cannot replace the snapshot " + path + ": " + std::strerror(rename_error));
+  }
+
+  const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+  const std::string directory = parent.empty() ? "." : parent.string();
+  const int directory_descriptor = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (directory_descriptor == -1 || ::fsync(directory_descriptor) == -1) {
+    const int sync_error = errno;
+    if (directory_descriptor != -1) {
+      ::close(directory_descriptor);
+    }
+    throw WriteException("Cannot sync the directory " + directory + ": " + std::strerror(sync_error));
+  }
+  ::close(directory_descriptor);
+  return checksum(image);
+}
+
+BookList BookListSnapshot::load(const std::string& path, std::size_t capacity) {
+  const MappedFile file(path);
+  return decode(file.contents(), capacity);
+}
@@ -0,0 +1,91 @@
+#ifndef _book_list_snapshot_hpp_
+#define _book_list_snapshot_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "book_list.hpp"
+
+// The BookListSnapshot class saves a BookList in a compact binary format and
+// loads it back by mapping the file into memory, which is far quicker than
+// going through the text format.
+//
+// A snapshot is a fixed header, one fixed-width record per book, then a
+// string table. All integers are little-endian:
+//
+//   header   8  magic, "BOOKLIST"
+//            4  format version
+//            4  reserved, zero
+//            8  number of records
+//            8  size of the string table in bytes
+//            8  FNV-1a hash of everything after the header
+//   record   4  ISBN offset into the string table
+//            4  title offset into the string table
+//            4  author offset into the string table
+//            4  reserved, zero
+//            8  price, as the bits of an IEEE 754 double
+//   strings     each string as a 4-byte length and its bytes
+//
+// The ISBN is a string table offset like the title and author, since a Book
+// places no limit on its length. Each distinct string is stored once, so a
+// catalog with many books by one author stores the author once.
+//
+// load() rejects a file whose size, version or checksum is wrong, so a
+// truncated or damaged snapshot is never half-loaded.
+class BookListSnapshot {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  struct FormatException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  // Thrown if a snapshot cannot be written.
+  struct WriteException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  // The format version save() writes and load() accepts.
+  static constexpr std::uint32_t version = 1;
+
+  //
+  // Saving and Loading
+  //
+
+  // Returns the snapshot of `book_list`, from the top of the list down.
+  static std::string encode(const BookList& book_list);
+
+  // Returns the book list held by the snapshot `image`, with room for
+  // `capacity` books.
+  //
+  // Throws FormatException if the image is not a valid snapshot.
+  static BookList decode(std::string_view image, std::size_t capacity = BookList::unbounded_capacity);
+
+  // Returns the checksum recorded in the header of the snapshot `image`,
+  // which identifies the snapshot without decoding it.
+  //
+  // Throws FormatException if the image is too short to have a header.
+  static std::uint64_t checksum(std::string_view image);
+
+  // Writes the snapshot of `book_list` to the file at `path` and returns its
+  // checksum. The snapshot is written to a temporary file that then replaces
+  // `path`, so a crash midway leaves any earlier snapshot intact. Both the
+  // file and the rename are synced to the disk before save() returns.
+  //
+  // Throws WriteException if the file cannot be written.
+  static std::uint64_t save(const BookList& book_list, const std::string& path);
+
+  // Maps the file at `path` into memory and returns the book list its
+  // snapshot holds, with room for `capacity` books.
+  //
+  // Throws MappedFile::OpenException if the file cannot be read, and
+  // FormatException if it is not a valid snapshot.
+  static BookList load(const std::string& path, std::size_t capacity = BookList::unbounded_capacity);
+};
+
+#endif
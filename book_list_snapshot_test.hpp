@@ -0,0 +1,101 @@
+// Unit tests for the BookListSnapshot class.
+
+#include <filesystem>
+#include <string>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "book_list_snapshot.hpp"
+#include "doctest.hpp"
+#include "mapped_file.hpp"
+#include "temporary_path.hpp"
+
+TEST_CASE("BookListSnapshot") {
+  BookList list(BookList::unbounded_capacity);
+  list += {
+      Book("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99),
+      Book("A \"quoted\" title", "Back\\slash", "123", 1e-7),
+      Book("", "", "", 0.0),
+      Book("Negative", "Price", "000", -2.5)
+  };
+  for (int i = 0; i < 50; ++i) {
+    list.insert(Book("Title-" + std::to_string(i), "Author", "isbn-" + std::to_string(i), i / 3.0),
+                BookList::Position::BOTTOM);
+  }
+  const std::string image = BookListSnapshot::encode(list);
+
+  SUBCASE("RoundTrip") {
+    CHECK_EQ(list, BookListSnapshot::decode(image));
+    CHECK_EQ(BookList(), BookListSnapshot::decode(BookListSnapshot::encode(BookList())));
+  }
+
+  SUBCASE("PricesAreExact") {
+    // The text format rounds prices to six significant digits; the snapshot
+    // keeps every bit.
+    const BookList exact({Book("title", "author", "isbn", 0.1 + 0.2)});
+    CHECK_EQ(0.1 + 0.2, BookListSnapshot::decode(BookListSnapshot::encode(exact)).at(0).price());
+  }
+
+  SUBCASE("StoresRepeatedStringsOnce") {
+    // One more record and 4 + 6 bytes for the new ISBN; the title and author
+    // are already in the string table.
+    BookList more = list;
+    more.insert(Book("Title-0", "Author", "isbn-x", 1.0), BookList::Position::BOTTOM);
+    CHECK_EQ(image.size() + 24 + 4 + 6, BookListSnapshot::encode(more).size());
+  }
+
+  SUBCASE("RespectsCapacity") {
+    CHECK_EQ(list.size(), BookListSnapshot::decode(image, list.size()).size());
+    if (BookList::stores_array) {
+      CHECK_THROWS_AS(BookListSnapshot::decode(image, 10), BookList::CapacityExceededException);
+    }
+  }
+
+  SUBCASE("RejectsTruncatedImage") {
+    for (std::size_t size : {std::size_t{0}, std::size_t{39}, std::size_t{40}, image.size() / 2, image.size() - 1}) {
+      CAPTURE(size);
+      CHECK_THROWS_AS(BookListSnapshot::decode(std::string_view(image).substr(0, size)),
+                      BookListSnapshot::FormatException);
+    }
+    CHECK_THROWS_AS(BookListSnapshot::decode(image + '\0'), BookListSnapshot::FormatException);
+  }
+
+  SUBCASE("RejectsDamagedImage") {
+    std::string damaged = image;
+    damaged[image.size() - 3] ^= 1;
+    CHECK_THROWS_WITH_AS(BookListSnapshot::decode(damaged), "Snapshot checksum mismatch",
+                         BookListSnapshot::FormatException);
+  }
+
+  SUBCASE("RejectsOtherFormats") {
+    std::string other = image;
+    other[0] = 'b';
+    CHECK_THROWS_WITH_AS(BookListSnapshot::decode(other), "Not a BookList snapshot",
+                         BookListSnapshot::FormatException);
+
+    std::string newer = image;
+    newer[8] = static_cast<char>(BookListSnapshot::version + 1);
+    CHECK_THROWS_WITH_AS(BookListSnapshot::decode(newer), "Unsupported snapshot version 2",
+                         BookListSnapshot::FormatException);
+  }
+
+  SUBCASE("SaveAndLoad") {
+    const TemporaryPath temporary("book_list_snapshot_test", ".bin");
+    const std::string& path = temporary.string();
+    BookListSnapshot::save(list, path);
+    CHECK_EQ(list, BookListSnapshot::load(path));
+    CHECK_EQ(image.size(), MappedFile(path).size());
+    CHECK_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    // An overwritten snapshot fully replaces the earlier one.
+    BookListSnapshot::save(BookList({Book("only")}), path);
+    CHECK_EQ(BookList({Book("only")}), BookListSnapshot::load(path));
+  }
+
+  SUBCASE("SaveFails") {
+    const TemporaryPath missing("book_list_snapshot_test", ".missing");
+    const std::string path = missing.string() + "/snapshot.bin";
+    CHECK_THROWS_AS(BookListSnapshot::save(list, path), BookListSnapshot::WriteException);
+    CHECK_FALSE(std::filesystem::exists(path + ".tmp"));
+  }
+}
@@ -1,8 +1,20 @@
 // Unit tests for the BookList class.
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#if __cplusplus >= 202002L
+#  include <ranges>
+#endif
+
+#include "allocation_counter.hpp"
 #include "book.hpp"
 #include "book_list.hpp"
 #include "doctest.hpp"
@@ -127,15 +139,113 @@ TEST_CASE("Modifiers") {
   }
 
 
+  SUBCASE("MoveToTopWithoutCopies") {
+    const Book long_book("A title long enough to allocate", "An author long enough to allocate",
+                         "An ISBN long enough to allocate", 8.0);
+    list.insert(long_book, BookList::Position::BOTTOM);
+
+    const std::size_t allocations =
+        allocation_counter::count([&] { list.move_to_top(long_book); });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ(list, BookList({long_book, book_2, book_1, book_4, book_5, book_6}));
+
+    list.move_to_top(book_4);
+    CHECK_EQ(0U, list.find(book_4));
+    CHECK_EQ(1U, list.find(long_book));
+    CHECK_EQ(2U, list.find(book_2));
+    CHECK_EQ(4U, list.find(book_5));
+  }
+
   SUBCASE("Insert") {
     BookList list;
 
-    CHECK_THROWS_AS(
-      {
-        for (int i = 0; i < 12; ++i) {
-          list.insert(Book{"Book-" + std::to_string(i)});
-        }
-      }, BookList::CapacityExceededException);
+    // Only the fixed capacity array limits how many books fit.
+    if (BookList::stores_array) {
+      CHECK_THROWS_AS(
+        {
+          for (int i = 0; i < 12; ++i) {
+            list.insert(Book{"Book-" + std::to_string(i)});
+          }
+        }, BookList::CapacityExceededException);
+    } else {
+      for (int i = 0; i < 12; ++i) {
+        list.insert(Book{"Book-" + std::to_string(i)});
+      }
+      CHECK_EQ(12U, list.size());
+    }
+  }
+
+  SUBCASE("Capacity") {
+    BookList small(3);
+    CHECK_EQ(small.capacity(), BookList::stores_array ? 3U : BookList::unbounded_capacity);
+    small += {book_1, book_2, book_3};
+    if (BookList::stores_array) {
+      CHECK_THROWS_AS(small.insert(book_4), BookList::CapacityExceededException);
+    }
+
+    BookList unbounded(BookList::unbounded_capacity);
+    for (int i = 0; i < 1000; ++i) {
+      unbounded.insert(Book{"Book-" + std::to_string(i)}, BookList::Position::BOTTOM);
+    }
+    CHECK_EQ(1000U, unbounded.size());
+    CHECK_EQ(999U, unbounded.find(Book{"Book-999"}));
+  }
+
+  SUBCASE("Reserve") {
+    BookList reserved(BookList::unbounded_capacity);
+    reserved += list;
+    reserved.reserve(100);
+    CHECK_EQ(list, reserved);
+    CHECK_EQ(BookList::unbounded_capacity, reserved.capacity());
+    for (int i = 0; i < 20; ++i) {
+      reserved.insert(Book{"Book-" + std::to_string(i)}, BookList::Position::BOTTOM);
+    }
+    reserved.validate();
+
+    // Room is never reserved past the capacity.
+    BookList small(3);
+    small.reserve(1000);
+    CHECK_EQ(small.capacity(), BookList::stores_array ? 3U : BookList::unbounded_capacity);
+  }
+
+  SUBCASE("MovedFromIsEmpty") {
+    BookList moved(std::move(list));
+    CHECK_EQ(5U, moved.size());
+    CHECK_EQ(0U, list.size());
+
+    list = std::move(moved);
+    CHECK_EQ(5U, list.size());
+    CHECK_EQ(0U, moved.size());
+  }
+
+  SUBCASE("InsertRvalue") {
+    const Book book("A title long enough to allocate", "An author long enough to allocate",
+                    "An ISBN long enough to allocate", 8.0);
+    BookList copied, moved;
+
+    const std::size_t book_copy_allocations =
+        allocation_counter::count([&] { const Book copy(book); });
+
+    const std::size_t copy_allocations =
+        allocation_counter::count([&] { copied.insert(book); });
+
+    Book temporary(book);
+    const std::size_t move_allocations =
+        allocation_counter::count([&] { moved.insert(std::move(temporary)); });
+
+    // Moving saves exactly the allocations of one copy of the book.
+    CHECK_LT(0U, book_copy_allocations);
+    CHECK_EQ(copy_allocations - book_copy_allocations, move_allocations);
+    CHECK_EQ(copied, moved);
+  }
+
+  SUBCASE("Emplace") {
+    BookList list = {book_2};
+    list.emplace(BookList::Position::TOP, "book_1");
+    list.emplace(2U, "book_3", "author", "isbn", 1.0);
+    list.emplace(BookList::Position::BOTTOM, "book_1");
+
+    CHECK_EQ(list, BookList({book_1, book_2, Book("book_3", "author", "isbn", 1.0)}));
   }
 
   SUBCASE("Chaining") {
@@ -148,6 +258,130 @@ TEST_CASE("Modifiers") {
   }
 }
 
+TEST_CASE("At") {
+  const Book book_1("book_1"), book_2("book_2");
+  const BookList list = {book_1, book_2};
+  CHECK_EQ(book_1, list.at(0));
+  CHECK_EQ(book_2, list.at(1));
+  CHECK_THROWS_AS(list.at(2), BookList::InvalidOffsetException);
+}
+
+TEST_CASE("FindAfterMutations") {
+  const Book book_1("book_1"),
+      book_2("book_2"),
+      book_3("book_3"),
+      book_4("book_4");
+  BookList list = {book_1, book_2, book_3};
+
+  SUBCASE("Insert") {
+    list.insert(book_4, 1U);
+    CHECK_EQ(0U, list.find(book_1));
+    CHECK_EQ(1U, list.find(book_4));
+    CHECK_EQ(2U, list.find(book_2));
+    CHECK_EQ(3U, list.find(book_3));
+
+    // Duplicates are still rejected.
+    list.insert(book_2, BookList::Position::BOTTOM);
+    CHECK_EQ(4U, list.size());
+    CHECK_EQ(2U, list.find(book_2));
+  }
+
+  SUBCASE("Remove") {
+    list.remove(book_1);
+    CHECK_EQ(0U, list.find(book_2));
+    CHECK_EQ(1U, list.find(book_3));
+    CHECK_EQ(2U, list.find(book_1));
+  }
+
+  SUBCASE("MoveToTop") {
+    list.move_to_top(book_3);
+    CHECK_EQ(0U, list.find(book_3));
+    CHECK_EQ(1U, list.find(book_1));
+    CHECK_EQ(2U, list.find(book_2));
+  }
+
+  SUBCASE("SwapAndCopy") {
+    BookList other = {book_4};
+    list.swap(other);
+    CHECK_EQ(0U, list.find(book_4));
+    CHECK_EQ(1U, list.find(book_1));
+    CHECK_EQ(2U, other.find(book_3));
+
+    const BookList copy(other);
+    CHECK_EQ(1U, copy.find(book_2));
+    CHECK_EQ(3U, copy.find(book_4));
+  }
+}
+
+TEST_CASE("BulkInsert") {
+  const Book book_1("book_1"),
+      book_2("book_2"),
+      book_3("book_3"),
+      book_4("book_4"),
+      book_5("book_5");
+  BookList list = {book_1, book_2};
+
+  SUBCASE("Append") {
+    const std::vector<Book> books = {book_3, book_1, book_4, book_3, book_5};
+    CHECK_EQ(&list, &list.append(books.begin(), books.end()));
+    CHECK_EQ(list, BookList({book_1, book_2, book_3, book_4, book_5}));
+    CHECK_EQ(4U, list.find(book_5));
+  }
+
+  SUBCASE("InsertRangeInMiddle") {
+    const std::vector<Book> books = {book_3, book_4};
+    list.insert_range(1U, books.begin(), books.end());
+    CHECK_EQ(list, BookList({book_1, book_3, book_4, book_2}));
+    CHECK_EQ(1U, list.find(book_3));
+    CHECK_EQ(3U, list.find(book_2));
+  }
+
+  SUBCASE("InsertRangeAtTop") {
+    const std::vector<Book> books = {book_5, book_4, book_2};
+    list.insert_range(0U, books.begin(), books.end());
+    CHECK_EQ(list, BookList({book_5, book_4, book_1, book_2}));
+  }
+
+  SUBCASE("InvalidOffset") {
+    const std::vector<Book> books = {book_3};
+    CHECK_THROWS_AS(list.insert_range(3U, books.begin(), books.end()),
+                    BookList::InvalidOffsetException);
+  }
+
+  SUBCASE("AppendToSelf") {
+    list += list;
+    CHECK_EQ(list, BookList({book_1, book_2}));
+  }
+
+  SUBCASE("RejectsBatchThatDoesNotFit") {
+    if (BookList::stores_array) {
+      BookList small(3);
+      small += {book_1};
+      CHECK_THROWS_AS((small += {book_2, book_3, book_4}), BookList::CapacityExceededException);
+      CHECK_EQ(small, BookList({book_1}));
+
+      // Duplicates do not count against the capacity.
+      small += {book_1, book_2, book_1, book_3};
+      CHECK_EQ(small, BookList({book_1, book_2, book_3}));
+    }
+  }
+
+  SUBCASE("LargeMerge") {
+    BookList lhs(BookList::unbounded_capacity), rhs(BookList::unbounded_capacity);
+    std::vector<Book> lhs_books, rhs_books;
+    for (int i = 0; i < 2000; ++i) {
+      lhs_books.emplace_back("Book-" + std::to_string(i));
+      rhs_books.emplace_back("Book-" + std::to_string(i + 1000));
+    }
+    lhs.append(lhs_books.begin(), lhs_books.end());
+    rhs.append(rhs_books.begin(), rhs_books.end());
+
+    lhs += rhs;
+    CHECK_EQ(3000U, lhs.size());
+    CHECK_EQ(2999U, lhs.find(Book("Book-2999")));
+  }
+}
+
 TEST_CASE("RelationalOperators") {
   SUBCASE("Comparison") {
     const Book a("a"), b("b");
@@ -225,7 +459,64 @@ TEST_CASE("StreamInsertion") {
   }
 }
 
+TEST_CASE("BufferedExport") {
+  BookList list(BookList::unbounded_capacity);
+  list += {
+      Book("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99),
+      Book("A \"quoted\" title", "Back\\slash", "123", 1.0),
+      Book("", "", "", 0.0),
+      Book("Tiny", "Huge", "456", 0.0000001),
+      Book("Big", "Small", "789", 123456789.0),
+      Book("Negative", "Price", "000", -2.5)
+  };
+  for (int i = 0; i < 200; ++i) {
+    list.insert(Book("Book-" + std::to_string(i), "Author", std::to_string(i), i / 7.0),
+                BookList::Position::BOTTOM);
+  }
+
+  std::stringstream expected;
+  expected << list;
+
+  SUBCASE("ToString") {
+    std::string buffer = "prefix";
+    CHECK_EQ(&buffer, &list.write_to(buffer));
+    CHECK_EQ("prefix" + expected.str(), buffer);
+  }
+
+  SUBCASE("ToSink") {
+    std::string output;
+    int chunks = 0;
+    list.write_to([&](std::string_view chunk) {
+      output += chunk;
+      ++chunks;
+    }, 256);
+    CHECK_EQ(expected.str(), output);
+    CHECK_LT(1, chunks);
+  }
+
+  SUBCASE("EmptyList") {
+    std::string buffer;
+    CHECK_EQ("0\n", BookList().write_to(buffer));
+  }
+}
+
 TEST_CASE("StreamExtraction") {
+  SUBCASE("StopsAtTruncatedInput") {
+    std::stringstream ss("3\n 0:  \"123\", \"A\", \"B\", 1\n");
+    BookList list;
+    ss >> list;
+    CHECK(ss.fail());
+    CHECK_EQ(BookList({Book("A", "B", "123", 1)}), list);
+  }
+
+  SUBCASE("StopsAtRepeatedBook") {
+    std::stringstream ss("2\n 0:  \"123\", \"A\", \"B\", 1\n 1:  \"123\", \"A\", \"B\", 1\n");
+    BookList list;
+    ss >> list;
+    CHECK(ss.fail());
+    CHECK_EQ(1U, list.size());
+  }
+
   SUBCASE("ReturnsReference") {
     std::stringstream ss("1\n 0:\"\",\"\",\"\",0\n");
     BookList b;
@@ -275,4 +566,449 @@ TEST_CASE("StreamExtraction") {
     CHECK_EQ(list2, BookList({Book("G", "H", "789", 3.0)
     }));
   }
-}
\ No newline at end of file
+}
+TEST_CASE("ParallelScans") {
+  // Long enough for find() and compare() to split their scans between threads
+  // when BOOK_LIST_PARALLEL_THREADS allows it.
+  const std::size_t count = BookList::parallel_threshold + 1000;
+  std::vector<Book> books;
+  books.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    books.emplace_back("title", "author", std::to_string(i));
+  }
+  BookList list(BookList::unbounded_capacity);
+  list.append(books.begin(), books.end());
+
+  SUBCASE("FindReportsLowestOffset") {
+    for (const std::size_t offset : {std::size_t{0}, count / 3, count / 2, count - 1}) {
+      CHECK_EQ(offset, list.find(books[offset]));
+    }
+    CHECK_EQ(count, list.find(Book("missing")));
+  }
+
+  SUBCASE("CompareReportsFirstDifference") {
+    CHECK_EQ(0, list.compare(BookList(list)));
+
+    // The later difference alone would order the lists the other way.
+    std::vector<Book> changed = books;
+    changed[count / 4] = Book("changed", "author", "0");
+    changed[count - 10] = Book("changed", "author", "99999999");
+    BookList other(BookList::unbounded_capacity);
+    other.append(changed.begin(), changed.end());
+
+    CHECK_EQ(1, list.compare(other));
+    CHECK_EQ(-1, other.compare(list));
+    CHECK(other < list);
+  }
+}
+
+TEST_CASE("MemoryResource") {
+  std::vector<Book> books;
+  for (int i = 0; i < 20; ++i) {
+    books.emplace_back("title", "author", std::to_string(i));
+  }
+
+  // With no upstream resource, any allocation the buffer cannot serve throws.
+  alignas(std::max_align_t) static unsigned char buffer[64 * 1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  BookList list(BookList::unbounded_capacity, &arena);
+
+  SUBCASE("ContainersAllocateFromResource") {
+    const std::size_t allocations = allocation_counter::count([&] {
+      for (const Book& book : books) {
+        list.insert(book, BookList::Position::BOTTOM);
+      }
+      list.move_to_top(books[10]).remove(books[3]);
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ(&arena, list.get_allocator().resource());
+    CHECK_EQ(19U, list.size());
+    CHECK_EQ(0U, list.find(books[10]));
+  }
+
+  SUBCASE("CopiesAndMoves") {
+    list.append(books.begin(), books.end());
+
+    const BookList copy(list);
+    CHECK_EQ(std::pmr::get_default_resource(), copy.get_allocator().resource());
+    CHECK_EQ(list, copy);
+
+    const BookList arena_copy(copy, &arena);
+    CHECK_EQ(&arena, arena_copy.get_allocator().resource());
+    CHECK_EQ(list, arena_copy);
+
+    // Assignment copies the books into the list's own resource.
+    BookList other(BookList::unbounded_capacity);
+    other = std::move(list);
+    CHECK_EQ(std::pmr::get_default_resource(), other.get_allocator().resource());
+    CHECK_EQ(copy, other);
+
+    BookList moved(std::move(other));
+    CHECK_EQ(std::pmr::get_default_resource(), moved.get_allocator().resource());
+    CHECK_EQ(copy, moved);
+  }
+}
+
+TEST_CASE("OrderedQueries") {
+  const Book book_1("Emma", "Austen", "isbn_1", 7.5),
+      book_2("Persuasion", "Austen", "isbn_2", 5.0),
+      book_3("Dubliners", "Joyce", "isbn_3", 9.0),
+      book_4("Ulysses", "Joyce", "isbn_4", 5.0),
+      book_5("Emma", "Tennant", "isbn_5", 12.0);
+
+  BookList list({book_1, book_2, book_3, book_4});
+
+  SUBCASE("Queries") {
+    CHECK_EQ(std::vector<std::size_t>({0, 1}), list.find_by_author("Austen"));
+    CHECK_EQ(std::vector<std::size_t>({2, 3}), list.find_by_author("Joyce"));
+    CHECK(list.find_by_author("Woolf").empty());
+    CHECK_EQ(std::vector<std::size_t>({0}), list.find_by_title("Emma"));
+    CHECK(list.find_by_title("").empty());
+
+    // Cheapest first, and list order among equal prices.
+    CHECK_EQ(std::vector<std::size_t>({1, 3, 0}), list.find_priced_between(5.0, 8.0));
+    CHECK_EQ(std::vector<std::size_t>({1, 3, 0, 2}), list.find_priced_between(0.0, 100.0));
+    CHECK(list.find_priced_between(10.0, 20.0).empty());
+    CHECK(list.find_priced_between(8.0, 5.0).empty());
+  }
+
+  SUBCASE("AfterMutations") {
+    list.insert(book_5, BookList::Position::TOP);
+    CHECK_EQ(std::vector<std::size_t>({0, 1}), list.find_by_title("Emma"));
+    CHECK_EQ(std::vector<std::size_t>({2, 4, 1, 3, 0}), list.find_priced_between(0.0, 100.0));
+
+    list.remove(book_2);
+    CHECK_EQ(std::vector<std::size_t>({1}), list.find_by_author("Austen"));
+    CHECK_EQ(std::vector<std::size_t>({3, 1, 2, 0}), list.find_priced_between(0.0, 100.0));
+
+    list.move_to_top(book_4);
+    CHECK_EQ(std::vector<std::size_t>({0, 3}), list.find_by_author("Joyce"));
+    CHECK_EQ(std::vector<std::size_t>({0, 2, 3, 1}), list.find_priced_between(0.0, 100.0));
+
+    const std::vector<Book> more({book_2, book_1});
+    list.insert_range(1, more.begin(), more.end());
+    CHECK_EQ(std::vector<std::size_t>({1, 3}), list.find_by_author("Austen"));
+
+    BookList other({book_3});
+    other.swap(list);
+    CHECK_EQ(std::vector<std::size_t>({0}), list.find_by_author("Joyce"));
+    CHECK_EQ(std::vector<std::size_t>({1, 3}), other.find_by_author("Austen"));
+  }
+
+  SUBCASE("MatchesScan") {
+    // Mixes the mutations, then checks every price query against the offsets
+    // a scan with at() finds.
+    BookList books(BookList::unbounded_capacity);
+    for (int i = 0; i < 200; ++i) {
+      const Book book("title_" + std::to_string(i % 7), "author_" + std::to_string(i % 5),
+                      std::to_string(i), static_cast<double>(i % 11));
+      switch (i % 4) {
+        case 0: books.insert(book, BookList::Position::TOP); break;
+        case 1: books.insert(book, books.size() / 2); break;
+        case 2: books.insert(book, BookList::Position::BOTTOM); break;
+        default: books.move_to_top(books.at(books.size() - 1)).remove(books.size() / 3); break;
+      }
+    }
+
+    for (double low = 0.0; low < 11.0; low += 2.0) {
+      std::vector<std::size_t> scanned;
+      for (double price = low; price <= low + 3.0; price += 1.0) {
+        for (std::size_t offset = 0; offset < books.size(); ++offset) {
+          if (books.at(offset).price() == price) {
+            scanned.push_back(offset);
+          }
+        }
+      }
+      CHECK_EQ(scanned, books.find_priced_between(low, low + 3.0));
+    }
+
+    for (std::size_t offset : books.find_by_author("author_3")) {
+      CHECK_EQ("author_3", books.at(offset).author());
+    }
+  }
+}
+
+TEST_CASE("Iteration") {
+  const Book book_1("title_1", "author", "isbn_1", 3.0),
+      book_2("title_2", "author", "isbn_2", 12.0),
+      book_3("title_3", "author", "isbn_3", 8.0);
+  const BookList list({book_1, book_2, book_3});
+
+  SUBCASE("RangeFor") {
+    std::vector<Book> walked;
+    for (const Book& book : list) {
+      walked.push_back(book);
+    }
+    CHECK_EQ(std::vector<Book>({book_1, book_2, book_3}), walked);
+    CHECK_EQ(3, std::distance(list.begin(), list.end()));
+    CHECK_EQ(list.begin(), list.cbegin());
+  }
+
+  SUBCASE("Algorithms") {
+    const auto pricey = std::find_if(list.begin(), list.end(),
+                                     [](const Book& book) { return book.price() > 10.0; });
+    REQUIRE_NE(list.end(), pricey);
+    CHECK_EQ(book_2, *pricey);
+    CHECK_EQ(&list.at(1), &*pricey);
+  }
+
+  SUBCASE("Subscript") {
+    CHECK_EQ(book_1, list[0]);
+    CHECK_EQ(book_3, list[2]);
+    CHECK_EQ(&list.at(2), &list[2]);
+  }
+
+  SUBCASE("Empty") {
+    const BookList empty;
+    CHECK(empty.empty());
+    CHECK_FALSE(list.empty());
+    CHECK_EQ(empty.begin(), empty.end());
+  }
+
+#if __cplusplus >= 202002L
+  SUBCASE("Views") {
+    static_assert(std::ranges::forward_range<const BookList&>);
+    std::vector<std::string> titles;
+    auto cheap_titles = list
+        | std::views::filter([](const Book& book) { return book.price() < 10.0; })
+        | std::views::transform([](const Book& book) -> const std::string& { return book.title(); });
+    for (const std::string& title : cheap_titles) {
+      titles.push_back(title);
+    }
+    CHECK_EQ(std::vector<std::string>({"title_1", "title_3"}), titles);
+  }
+#endif
+}
+
+
+TEST_CASE("Validate") {
+  std::vector<Book> books;
+  for (int i = 0; i < 100; ++i) {
+    books.emplace_back("title", "author", std::to_string(i));
+  }
+  BookList list(BookList::unbounded_capacity);
+  list.append(books.begin(), books.end());
+  list.validate();
+
+  SUBCASE("AfterEachMutator") {
+    list.insert(Book("top"));
+    list.validate();
+    list.insert(Book("bottom"), BookList::Position::BOTTOM);
+    list.remove(std::size_t{50});
+    list.validate();
+    list.move_to_top(books[80]);
+    list.remove(Book("bottom"));
+    list.validate();
+
+    CHECK_EQ(100U, list.size());
+    CHECK_EQ(books[80], list.at(0));
+    CHECK_EQ(Book("top"), list.at(1));
+    CHECK_EQ(books[99], list.at(99));
+    CHECK_EQ(books[50], list.at(51));
+  }
+
+  SUBCASE("SwappedLists") {
+    BookList other(BookList::unbounded_capacity);
+    other.insert(Book("other"));
+    list.swap(other);
+    list.validate();
+    other.validate();
+    CHECK_EQ(1U, list.size());
+  }
+
+#if BOOK_LIST_INSTRUMENTATION
+  SUBCASE("SweepsOnlyTheChangedBooks") {
+    using Operation = BookList::Operation;
+    constexpr std::size_t stored = BookList::stores_array + BookList::stores_vector
+        + BookList::stores_sl_list + BookList::stores_dl_list + BookList::stores_chunked;
+    constexpr std::size_t walking = BookList::stores_sl_list + BookList::stores_dl_list;
+
+    // Only the new bottom book is compared, after the lists walk down to it.
+    list.insert(Book("bottom"), BookList::Position::BOTTOM);
+    BookList::reset_stats();
+    list.validate();
+    CHECK_EQ(stored + walking * 100, BookList::stats()[Operation::consistency_check].elements_scanned);
+
+    // Nothing has changed since.
+    BookList::reset_stats();
+    list.validate();
+    CHECK_EQ(0U, BookList::stats()[Operation::consistency_check].elements_scanned);
+  }
+#endif
+}
+
+TEST_CASE("Reconciliation") {
+  using Kind = BookList::Edit::Kind;
+
+  std::vector<Book> books;
+  for (int i = 0; i < 100; ++i) {
+    books.emplace_back("title", "author", std::to_string(i));
+  }
+  BookList list(BookList::unbounded_capacity);
+  list.append(books.begin(), books.end());
+  BookList target(list);
+
+  SUBCASE("EqualLists") {
+    CHECK(list.diff(target).empty());
+    list.apply({});
+    CHECK_EQ(target, list);
+  }
+
+  SUBCASE("MinimalScript") {
+    // One book removed, one inserted, and one moved down: everything else
+    // keeps its relative order, so only those three need an edit.
+    target.remove(std::size_t{10});
+    target.insert(Book("new"), 20);
+    target.remove(books[60]);
+    target.insert(books[60], 90);
+
+    const BookList::Diff script = list.diff(target);
+    REQUIRE_EQ(3U, script.size());
+    CHECK_EQ(Kind::REMOVE, script[0].kind);
+    CHECK_EQ(books[10], script[0].book);
+    CHECK_EQ(10U, script[0].offset);
+    CHECK_EQ(Kind::INSERT, script[1].kind);
+    CHECK_EQ(Book("new"), script[1].book);
+    CHECK_EQ(20U, script[1].offset);
+    CHECK_EQ(Kind::MOVE, script[2].kind);
+    CHECK_EQ(books[60], script[2].book);
+    CHECK_EQ(90U, script[2].offset);
+
+    list.apply(script);
+    CHECK_EQ(target, list);
+  }
+
+  SUBCASE("Reordered") {
+    // Reversing the list keeps one book in place and moves the rest.
+    BookList reversed(BookList::unbounded_capacity);
+    reversed.append(books.rbegin(), books.rend());
+    const BookList::Diff script = list.diff(reversed);
+    CHECK_EQ(99U, script.size());
+    CHECK(std::all_of(script.begin(), script.end(), [](const BookList::Edit& edit) {
+      return edit.kind == Kind::MOVE;
+    }));
+    list.apply(script);
+    CHECK_EQ(reversed, list);
+  }
+
+  SUBCASE("ScrambledLists") {
+    // Books dropped, added and moved all over the list.
+    for (int i = 0; i < 100; i += 7) {
+      target.remove(books[i]);
+    }
+    for (int i = 0; i < 100; i += 11) {
+      target.move_to_top(books[i]);
+    }
+    for (int i = 0; i < 30; ++i) {
+      target.insert(Book("new", "author", std::to_string(i)), static_cast<std::size_t>(i * 3));
+    }
+    list.apply(list.diff(target));
+    CHECK_EQ(target, list);
+
+    // And back again.
+    BookList original(BookList::unbounded_capacity);
+    original.append(books.begin(), books.end());
+    list.apply(list.diff(original));
+    CHECK_EQ(original, list);
+  }
+
+  SUBCASE("ToAndFromEmpty") {
+    const BookList empty(BookList::unbounded_capacity);
+    BookList copy(empty);
+    copy.apply(copy.diff(list));
+    CHECK_EQ(list, copy);
+    copy.apply(copy.diff(empty));
+    CHECK_EQ(empty, copy);
+  }
+
+  SUBCASE("InvalidScripts") {
+    const BookList before(list);
+    CHECK_THROWS_AS(list.apply({{Kind::REMOVE, Book("missing"), 0}}), BookList::InvalidDiffException);
+    CHECK_THROWS_AS(list.apply({{Kind::MOVE, books[1], 0}, {Kind::MOVE, books[2], 0}}), BookList::InvalidDiffException);
+    CHECK_THROWS_AS(list.apply({{Kind::INSERT, Book("new"), 101}}), BookList::InvalidDiffException);
+    CHECK_THROWS_AS(list.apply({{Kind::INSERT, books[1], 0}}), BookList::InvalidDiffException);
+    CHECK_THROWS_AS(list.apply({{Kind::REMOVE, books[1], 1}, {Kind::REMOVE, books[1], 1}}), BookList::InvalidDiffException);
+    CHECK_EQ(before, list);
+  }
+}
+
+TEST_CASE("Instrumentation") {
+  using Operation = BookList::Operation;
+
+  const Book book_1("book_1"), book_2("book_2"), book_3("book_3");
+  BookList list(BookList::unbounded_capacity);
+  BookList::reset_stats();
+
+  SUBCASE("OperationNames") {
+    CHECK_EQ(std::string("move_to_top"), BookList::operation_name(Operation::move_to_top));
+    CHECK_EQ(std::string("consistency_check"), BookList::operation_name(Operation::consistency_check));
+  }
+
+#if BOOK_LIST_INSTRUMENTATION
+  SUBCASE("CountsCallsAndWork") {
+    constexpr std::size_t stored = BookList::stores_array + BookList::stores_vector
+        + BookList::stores_sl_list + BookList::stores_dl_list + BookList::stores_chunked;
+    constexpr std::size_t shifting = BookList::stores_array + BookList::stores_vector;
+
+    // Each lvalue insert copies the book once for every container; the second
+    // shifts the first book down in the array and the vector.
+    list.insert(book_1).insert(book_2);
+    BookList::Stats stats = BookList::stats();
+    CHECK_EQ(2U, stats[Operation::insert].calls);
+    CHECK_EQ(2 * stored, stats[Operation::insert].books_copied);
+    CHECK_EQ(shifting, stats[Operation::insert].books_shifted);
+    CHECK_GE(stats[Operation::find].calls, 2U);
+    CHECK_GE(stats[Operation::insert].nanoseconds, stats[Operation::find].nanoseconds);
+
+    // The nested calls' counts are included in the insert's.
+    CHECK_GE(stats[Operation::insert].elements_scanned, stats[Operation::find].elements_scanned);
+    if (BOOK_LIST_VALIDATION_LEVEL != BOOK_LIST_VALIDATION_OFF) {
+      CHECK_GT(stats[Operation::consistency_check].calls, 0U);
+    }
+
+    BookList::reset_stats();
+    CHECK_EQ(0, list.compare(BookList({book_2, book_1})));
+    stats = BookList::stats();
+    CHECK_EQ(1U, stats[Operation::compare].calls);
+    CHECK_EQ(0U, stats[Operation::insert].calls);
+    CHECK_EQ(0U, stats[Operation::remove].calls);
+
+    // Removing by book is one remove, however it is carried out.
+    list.remove(book_2).remove(book_3);
+    CHECK_EQ(2U, BookList::stats()[Operation::remove].calls);
+  }
+
+  SUBCASE("Hook") {
+    struct Recorder : BookList::StatsHook {
+      std::vector<Operation> operations;
+
+      void on_call(Operation operation, const BookList::CallStats& call) override {
+        CHECK_EQ(1U, call.calls);
+        operations.push_back(operation);
+      }
+    } recorder;
+
+    list.insert(book_1);
+    BookList::set_stats_hook(&recorder);
+    list.at(0);
+    BookList::set_stats_hook(nullptr);
+    list.at(0);
+
+    // at() calls size(), which checks consistency, so the calls it made are
+    // reported before it.
+    REQUIRE_FALSE(recorder.operations.empty());
+    CHECK_EQ(Operation::at, recorder.operations.back());
+    CHECK_EQ(1, std::count(recorder.operations.begin(), recorder.operations.end(), Operation::at));
+    CHECK_EQ(1, std::count(recorder.operations.begin(), recorder.operations.end(), Operation::size));
+  }
+#else
+  SUBCASE("RecordsNothingWhenDisabled") {
+    list.insert(book_1).insert(book_2).remove(book_1);
+    const BookList::Stats stats = BookList::stats();
+    for (const BookList::CallStats& call : stats.operations) {
+      CHECK_EQ(0U, call.calls);
+      CHECK_EQ(0U, call.nanoseconds);
+    }
+  }
+#endif
+}
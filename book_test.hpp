@@ -1,10 +1,17 @@
 // Unit tests for the Book class.
 
+#include <cstddef>
+#include <functional>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 
+#include "allocation_counter.hpp"
 #include "book.hpp"
 #include "doctest.hpp"
+#include "string_pool.hpp"
 
 TEST_CASE("ConstructorsAndAssignment") {
   SUBCASE("DefaultConstructor") {
@@ -40,6 +47,54 @@ TEST_CASE("ConstructorsAndAssignment") {
     CHECK_EQ("c", c.isbn());
     CHECK_EQ(8.0, c.price());
   }  
+
+  SUBCASE("MoveConstructor") {
+    // Strings too long for the small string optimization, so copying them
+    // would allocate.
+    Book b("A title long enough to allocate", "An author long enough to allocate",
+           "An ISBN long enough to allocate", 8.0);
+    std::optional<Book> c;
+    const std::size_t allocations = allocation_counter::count([&] {
+      c.emplace(std::move(b));
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ("A title long enough to allocate", c->title());
+    CHECK_EQ("An author long enough to allocate", c->author());
+    CHECK_EQ("An ISBN long enough to allocate", c->isbn());
+    CHECK_EQ(8.0, c->price());
+  }
+
+  SUBCASE("MoveAssignment") {
+    Book b("A title long enough to allocate", "An author long enough to allocate",
+           "An ISBN long enough to allocate", 8.0);
+    Book c;
+    const std::size_t allocations = allocation_counter::count([&] {
+      c = std::move(b);
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ("A title long enough to allocate", c.title());
+    CHECK_EQ("An author long enough to allocate", c.author());
+    CHECK_EQ("An ISBN long enough to allocate", c.isbn());
+    CHECK_EQ(8.0, c.price());
+  }
+
+  SUBCASE("MovedFromIsEmpty") {
+    // The cached hash and ISBN key must follow the attributes out, or the
+    // source would compare as neither its old self nor an empty book.
+    Book b("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99);
+    const Book moved(std::move(b));
+    CHECK_EQ(Book(), b);
+    CHECK_EQ(Book().hash(), b.hash());
+    CHECK_EQ(Book().isbn_key(), b.isbn_key());
+    CHECK_FALSE(b < Book());
+    CHECK_FALSE(Book() < b);
+
+    Book c("A title long enough to allocate", "An author", "An ISBN long enough to allocate", 1.0);
+    b = std::move(c);
+    CHECK_EQ(Book(), c);
+    CHECK_EQ(Book().hash(), c.hash());
+    CHECK_EQ("An ISBN long enough to allocate", b.isbn());
+  }
 }
 
 TEST_CASE("Accessors") {
@@ -58,6 +113,109 @@ TEST_CASE("Accessors") {
     CHECK_EQ("c", b.isbn());
     CHECK_EQ(8.0, b.price());
   }
+
+  SUBCASE("NeverAllocate") {
+    // Long enough that any copy of them would allocate, and read through a
+    // non-const book.
+    Book b("A title long enough to allocate", "An author long enough to allocate",
+           "An ISBN long enough to allocate", 8.0);
+    std::size_t length = 0;
+    const std::size_t allocations = allocation_counter::count([&] {
+      length = b.title().size() + b.author().size() + b.isbn().size();
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ(95U, length);
+  }
+}
+
+TEST_CASE("StringViews") {
+  const std::string_view title = "A title long enough to allocate",
+      author = "An author long enough to allocate",
+      isbn = "9780064430173";
+  const Book pooled(title, author, isbn, 1.0);
+
+  SUBCASE("Constructor") {
+    // The title and author are already pooled and the ISBN fits the small
+    // string buffer, so nothing is allocated.
+    std::optional<Book> b;
+    const std::size_t allocations = allocation_counter::count([&] {
+      b.emplace(title, author, isbn, 1.0);
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ(pooled, *b);
+  }
+
+  SUBCASE("Setters") {
+    Book b("t", "a", "9790619213090");
+    const std::size_t allocations = allocation_counter::count([&] {
+      b.title(title).author(author).isbn(isbn).price(1.0);
+    });
+    CHECK_EQ(0U, allocations);
+    CHECK_EQ(pooled, b);
+  }
+
+  SUBCASE("NotNullTerminated") {
+    const std::string_view text = "9780064430173-extra";
+    const Book b(text.substr(0, 5), text.substr(5, 3), text.substr(0, 13));
+    CHECK_EQ("97800", b.title());
+    CHECK_EQ("644", b.author());
+    CHECK_EQ("9780064430173", b.isbn());
+  }
+}
+
+TEST_CASE("SharedStrings") {
+  const Book a("Title", "Author", "9790619213090", 1.0);
+  Book b("Other Title", "Author", "979010181X", 2.0);
+  const Book& const_b = b;
+
+  // Books with the same author share one copy of it.
+  CHECK_EQ(&a.author(), &const_b.author());
+  CHECK_NE(&a.title(), &const_b.title());
+
+  b.title("Title");
+  CHECK_EQ(&a.title(), &const_b.title());
+
+  b.author("Someone Else");
+  CHECK_NE(&a.author(), &const_b.author());
+  CHECK_EQ("Author", a.author());
+}
+
+TEST_CASE("CachedKeys") {
+  Book b("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99);
+  const Book copy(b);
+
+  SUBCASE("EqualBooksHashEqually") {
+    CHECK_EQ(b.hash(), copy.hash());
+    CHECK_EQ(b.hash(), Book(b.title(), b.author(), b.isbn(), b.price()).hash());
+    CHECK_EQ(b.hash(), std::hash<Book>{}(b));
+  }
+
+  SUBCASE("ModifiersUpdateHash") {
+    b.title("x");
+    CHECK_NE(copy.hash(), b.hash());
+    b.title(copy.title());
+    CHECK_EQ(copy.hash(), b.hash());
+
+    b.price(1.0).isbn("z").author("y");
+    CHECK_EQ(Book(copy.title(), "y", "z", 1.0).hash(), b.hash());
+  }
+
+  SUBCASE("ExtractionUpdatesHash") {
+    std::stringstream ss("\"9780064430173\",\"Goodnight Moon\",\"Margaret Wise Brown\",8.99\n");
+    Book extracted;
+    ss >> extracted;
+    CHECK_EQ(copy.hash(), extracted.hash());
+    CHECK_EQ(copy, extracted);
+  }
+
+  SUBCASE("OrdersByLongIsbnPrefixes") {
+    // ISBNs that agree in their first eight characters fall back to
+    // comparing the whole string.
+    CHECK(Book("", "", "97800644301730", 0.0) < Book("", "", "97800644301731", 0.0));
+    CHECK(Book("", "", "97800644", 0.0) < Book("", "", "978006443", 0.0));
+    CHECK(Book("", "", "9", 0.0) < Book("", "", "978", 0.0));
+    CHECK_FALSE(Book("", "", "978", 0.0) < Book("", "", "9", 0.0));
+  }
 }
 
 TEST_CASE("Modifiers") {
@@ -220,6 +378,22 @@ TEST_CASE("StreamInsertion") {
   }
 }
 
+TEST_CASE("WriteTo") {
+  const Book books[] = {
+      Book("title", "author", "isbn", 1.0),
+      Book(),
+      Book("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99),
+      Book("A \"quoted\" title", "Back\\slash", "123", 1e-7),
+      Book("Big", "Small", "789", 123456789.0)
+  };
+  for (const Book& book : books) {
+    std::stringstream ss;
+    ss << book;
+    std::string buffer;
+    CHECK_EQ(ss.str(), book.write_to(buffer));
+  }
+}
+
 TEST_CASE("StreamExtraction") {
   SUBCASE("ReturnsReferenceToExtraction") {
     std::stringstream ss("\"\",\"\",\"\",0\n");
@@ -257,6 +431,16 @@ TEST_CASE("StreamExtraction") {
     CHECK_EQ(8.99, b.price());
   }
 
+  SUBCASE("FailedExtractionChangesNothing") {
+    std::stringstream ss("\"isbn\",\"never pooled title\",\"never pooled author\",not a price\n");
+    Book b("title", "author", "isbn", 1.0);
+    const std::size_t pooled = StringPool::shared().size();
+    ss >> b;
+    CHECK(ss.fail());
+    CHECK_EQ(Book("title", "author", "isbn", 1.0), b);
+    CHECK_EQ(pooled, StringPool::shared().size());
+  }
+
   SUBCASE("ChainedExtraction") {
     std::stringstream ss("\"123\",\"A\",\"B\",1\n"
       "\"456\",\"D\",\"E\",2\n"
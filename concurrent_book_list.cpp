@@ -0,0 +1,83 @@
+#include "concurrent_book_list.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+ConcurrentBookList::ConcurrentBookList(std::size_t capacity) : books_(capacity) {}
+
+ConcurrentBookList::ConcurrentBookList(BookList books)
+    : books_(std::move(books)),
+      size_(books_.size()) {}
+
+ConcurrentBookList::~ConcurrentBookList() noexcept = default;
+
+//
+// Queries
+//
+
+std::size_t ConcurrentBookList::size() const noexcept {
+  return size_.load(std::memory_order_acquire);
+}
+
+std::uint64_t ConcurrentBookList::version() const noexcept {
+  return version_.load(std::memory_order_acquire);
+}
+
+std::size_t ConcurrentBookList::find(const Book& book) const {
+  std::shared_lock lock(mutex_);
+  return books_.find(book);
+}
+
+Book ConcurrentBookList::at(std::size_t offset_from_top) const {
+  std::shared_lock lock(mutex_);
+  return books_.at(offset_from_top);
+}
+
+BookList ConcurrentBookList::books() const {
+  std::shared_lock lock(mutex_);
+  return books_;
+}
+
+//
+// Mutators
+//
+
+ConcurrentBookList& ConcurrentBookList::insert(const Book& book, BookList::Position position) {
+  write([&](BookList& books) { books.insert(book, position); });
+  return *this;
+}
+
+ConcurrentBookList& ConcurrentBookList::insert(Book&& book, BookList::Position position) {
+  write([&](BookList& books) { books.insert(std::move(book), position); });
+  return *this;
+}
+
+ConcurrentBookList& ConcurrentBookList::insert(const Book& book, std::size_t offset_from_top) {
+  write([&](BookList& books) { books.insert(book, offset_from_top); });
+  return *this;
+}
+
+ConcurrentBookList& ConcurrentBookList::remove(const Book& book) {
+  write([&](BookList& books) { books.remove(book); });
+  return *this;
+}
+
+ConcurrentBookList& ConcurrentBookList::remove(std::size_t offset_from_top) {
+  write([&](BookList& books) { books.remove(offset_from_top); });
+  return *this;
+}
+
+ConcurrentBookList& ConcurrentBookList::move_to_top(const Book& book) {
+  write([&](BookList& books) { books.move_to_top(book); });
+  return *this;
+}
@@ -0,0 +1,178 @@
+#ifndef _concurrent_book_list_hpp_
+#define _concurrent_book_list_hpp_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The ConcurrentBookList class wraps a BookList for use from many threads at
+// once. Any number of readers share the list, while each writer has it to
+// itself:
+//
+//   - Queries take a shared lock, so readers never wait on each other.
+//   - Mutators take an exclusive lock. transaction() holds that lock across a
+//     whole burst of writes, so the burst pays for one lock and other threads
+//     see all of it or none of it.
+//   - size() and version() read atomics without locking. read_cached() builds
+//     an optimistic read on version(): a reader keeps the result of an
+//     earlier read and reuses it, without touching the lock, for as long as
+//     no writer has changed the list since.
+class ConcurrentBookList {
+ public:
+  //
+  // Types
+  //
+
+  // A version no list ever has, so a default Cached is never current.
+  static constexpr std::uint64_t no_version = ~std::uint64_t{0};
+
+  // The result of a read_cached() call and the list version it was read at.
+  template <typename Result>
+  struct Cached {
+    std::uint64_t version = no_version;
+    Result value{};
+  };
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor constructs an empty list holding up to `capacity` books.
+  explicit ConcurrentBookList(std::size_t capacity = BookList::default_capacity);
+
+  // This constructor takes over the books in `books`.
+  explicit ConcurrentBookList(BookList books);
+
+  // The lock cannot be shared between lists, so they cannot be copied or
+  // moved; copy the books out with books() instead.
+  ConcurrentBookList(const ConcurrentBookList& other) = delete;
+  ConcurrentBookList& operator=(const ConcurrentBookList& rhs) = delete;
+
+  // The destructor.
+  ~ConcurrentBookList() noexcept;
+
+  //
+  // Queries
+  //
+
+  // Returns the number of books in the list, without locking.
+  std::size_t size() const noexcept;
+
+  // Returns the version of the list, without locking. It starts at zero and
+  // changes whenever a writer may have changed the list.
+  std::uint64_t version() const noexcept;
+
+  // These behave like the BookList methods of the same name, under a shared
+  // lock. at() returns a copy, since the list may change once it returns.
+  std::size_t find(const Book& book) const;
+  Book at(std::size_t offset_from_top) const;
+
+  // Returns a copy of the whole list.
+  BookList books() const;
+
+  // Calls `reader` with the book list under a shared lock and returns what it
+  // returns. `reader` must not keep references to the books past the call.
+  template <typename Reader>
+  auto read(Reader&& reader) const;
+
+  // Returns cache.value if the list has not changed since it was read.
+  // Otherwise calls `reader` with the book list under a shared lock, stores
+  // its result and the version it was read at in `cache`, and returns it.
+  //
+  // When the list rarely changes, this costs one atomic load: cheaper than
+  // taking even a shared lock, which every reader has to write to.
+  template <typename Result, typename Reader>
+  const Result& read_cached(Cached<Result>& cache, Reader&& reader) const;
+
+  //
+  // Mutators
+  //
+
+  // These behave like the BookList methods of the same name, under an
+  // exclusive lock.
+  ConcurrentBookList& insert(const Book& book, BookList::Position position = BookList::Position::TOP);
+  ConcurrentBookList& insert(Book&& book, BookList::Position position = BookList::Position::TOP);
+  ConcurrentBookList& insert(const Book& book, std::size_t offset_from_top);
+  ConcurrentBookList& remove(const Book& book);
+  ConcurrentBookList& remove(std::size_t offset_from_top);
+  ConcurrentBookList& move_to_top(const Book& book);
+
+  // Calls `writer` with the book list under one exclusive lock and returns
+  // what it returns, so a burst of writes is applied as one. If `writer`
+  // throws, the changes it made before throwing stay made.
+  template <typename Writer>
+  auto transaction(Writer&& writer);
+
+ private:
+  // Runs `operation` on books_ under the exclusive lock, then publishes the
+  // new size and version. The version is bumped even if `operation` throws,
+  // since it may have changed the list before it did.
+  template <typename Operation>
+  auto write(Operation&& operation);
+
+  mutable std::shared_mutex mutex_;
+
+  BookList books_;
+
+  // Mirror books_.size() and the number of writes, for reading without the
+  // lock. Only written under the exclusive lock.
+  std::atomic<std::size_t> size_{0};
+  std::atomic<std::uint64_t> version_{0};
+};
+
+//
+// Template Member Definitions
+//
+
+template <typename Reader>
+auto ConcurrentBookList::read(Reader&& reader) const {
+  std::shared_lock lock(mutex_);
+  return std::forward<Reader>(reader)(static_cast<const BookList&>(books_));
+}
+
+template <typename Result, typename Reader>
+const Result& ConcurrentBookList::read_cached(Cached<Result>& cache, Reader&& reader) const {
+  if (cache.version == version_.load(std::memory_order_acquire)) {
+    return cache.value;
+  }
+
+  // The version cannot change while the shared lock is held.
+  std::shared_lock lock(mutex_);
+  cache.value = std::forward<Reader>(reader)(static_cast<const BookList&>(books_));
+  cache.version = version_.load(std::memory_order_relaxed);
+  return cache.value;
+}
+
+template <typename Writer>
+auto ConcurrentBookList::transaction(Writer&& writer) {
+  return write(std::forward<Writer>(writer));
+}
+
+template <typename Operation>
+auto ConcurrentBookList::write(Operation&& operation) {
+  // Publishes the size and version when the scope ends, by return or throw,
+  // while the lock is still held. If the list has become inconsistent, the
+  // size is left as it was rather than thrown from a destructor.
+  struct Publisher {
+    ConcurrentBookList& list;
+    ~Publisher() {
+      try {
+        list.size_.store(list.books_.size(), std::memory_order_relaxed);
+      } catch (...) {
+      }
+      list.version_.fetch_add(1, std::memory_order_release);
+    }
+  };
+
+  std::unique_lock lock(mutex_);
+  const Publisher publisher{*this};
+  return std::forward<Operation>(operation)(books_);
+}
+
+#endif
@@ -0,0 +1,133 @@
+// Benchmarks for ConcurrentBookList under many readers and one writer.
+//
+// This is a standalone program, like book_list_benchmark.cpp. It compares
+// three ways of sharing a book list, each with 1 to 64 reader threads calling
+// find() while one writer thread keeps moving books to the top:
+//
+//   std::mutex      a plain BookList behind one mutex, as before.
+//   shared lock     ConcurrentBookList::find(), under a shared lock.
+//   optimistic      ConcurrentBookList::read_cached(), which skips the lock
+//                   while the list is unchanged.
+//
+//   g++ -std=c++17 -O2 -pthread book.cpp book_array.cpp book_chunks.cpp book_list.cpp concurrent_book_list.cpp string_pool.cpp concurrent_book_list_benchmark.cpp
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "concurrent_book_list.hpp"
+
+namespace {
+  // The number of books in the shared list.
+  constexpr std::size_t list_size = 1000;
+
+  // How long each configuration runs.
+  constexpr std::chrono::milliseconds duration{200};
+
+  // How long the writer waits between writes.
+  constexpr std::chrono::microseconds write_interval{100};
+
+  std::vector<Book> make_books(std::size_t count) {
+    std::vector<Book> books;
+    for (std::size_t i = 0; i < count; ++i) {
+      books.emplace_back("Title-" + std::to_string(i),
+                         "Author-" + std::to_string(i % 3),
+                         "978000000" + std::to_string(1000 + i),
+                         10.0 + i);
+    }
+    return books;
+  }
+
+  // Runs `readers` threads calling `read` and one thread calling `write`
+  // every write_interval for `duration`, and reports the reads per second.
+  template <typename Read, typename Write>
+  void run(const std::string& name, int readers, Read read, Write write) {
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> reads{0};
+    std::atomic<std::size_t> sink{0};
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+      threads.emplace_back([&, r] {
+        std::size_t count = 0;
+        std::size_t found = 0;
+        auto reader = read(r);
+        while (!done.load(std::memory_order_relaxed)) {
+          found += reader();
+          ++count;
+        }
+        reads += count;
+        sink += found;
+      });
+    }
+    threads.emplace_back([&] {
+      for (std::size_t i = 0; !done.load(std::memory_order_relaxed); ++i) {
+        write(i);
+        std::this_thread::sleep_for(write_interval);
+      }
+    });
+
+    std::this_thread::sleep_for(duration);
+    done = true;
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    const double seconds = std::chrono::duration<double>(duration).count();
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(4) << readers
+              << std::setw(16) << std::fixed << std::setprecision(0) << reads / seconds << " reads/s\n";
+  }
+}
+
+int main() {
+  const std::vector<Book> books = make_books(list_size);
+  BookList initial(BookList::unbounded_capacity);
+  initial.append(books.begin(), books.end());
+
+  std::cout << "list size: " << list_size << ", one writer every "
+            << write_interval.count() << " us\n";
+
+  for (int readers = 1; readers <= 64; readers *= 2) {
+    BookList guarded = initial;
+    std::mutex mutex;
+    run("std::mutex", readers,
+        [&](int r) {
+          return [&, r] {
+            std::lock_guard lock(mutex);
+            return guarded.find(books[r % list_size]);
+          };
+        },
+        [&](std::size_t i) {
+          std::lock_guard lock(mutex);
+          guarded.move_to_top(books[i % list_size]);
+        });
+
+    ConcurrentBookList shared(initial);
+    run("shared lock", readers,
+        [&](int r) { return [&, r] { return shared.find(books[r % list_size]); }; },
+        [&](std::size_t i) { shared.move_to_top(books[i % list_size]); });
+
+    ConcurrentBookList optimistic(initial);
+    run("optimistic", readers,
+        [&](int r) {
+          return [&, r, cache = ConcurrentBookList::Cached<std::size_t>()]() mutable {
+            return optimistic.read_cached(cache, [&](const BookList& list) {
+              return list.find(books[r % list_size]);
+            });
+          };
+        },
+        [&](std::size_t i) { optimistic.move_to_top(books[i % list_size]); });
+
+    std::cout << '\n';
+  }
+
+  return 0;
+}
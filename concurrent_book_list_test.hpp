@@ -0,0 +1,125 @@
+// Unit tests for the ConcurrentBookList class.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "concurrent_book_list.hpp"
+#include "doctest.hpp"
+
+TEST_CASE("ConcurrentBookList") {
+  const Book book_1("title_1", "author", "isbn_1"),
+      book_2("title_2", "author", "isbn_2"),
+      book_3("title_3", "author", "isbn_3");
+
+  ConcurrentBookList list(BookList::unbounded_capacity);
+
+  SUBCASE("BehavesLikeBookList") {
+    list.insert(book_1).insert(book_2, BookList::Position::BOTTOM).insert(book_3, 1).move_to_top(book_2);
+    CHECK_EQ(BookList({book_2, book_1, book_3}), list.books());
+    CHECK_EQ(3U, list.size());
+    CHECK_EQ(2U, list.find(book_3));
+    CHECK_EQ(book_1, list.at(1));
+
+    list.remove(book_1).remove(std::size_t{0});
+    CHECK_EQ(BookList({book_3}), list.books());
+    CHECK_EQ(1U, list.size());
+  }
+
+  SUBCASE("VersionCountsWrites") {
+    CHECK_EQ(0U, list.version());
+    list.insert(book_1);
+    list.transaction([&](BookList& books) { books.insert(book_2).insert(book_3); });
+    CHECK_EQ(2U, list.version());
+    list.find(book_1);
+    list.books();
+    CHECK_EQ(2U, list.version());
+  }
+
+  SUBCASE("TransactionReturnsResult") {
+    const std::size_t offset = list.transaction([&](BookList& books) {
+      books.insert(book_1).insert(book_2);
+      return books.find(book_1);
+    });
+    CHECK_EQ(1U, offset);
+    CHECK_EQ(2U, list.read([](const BookList& books) { return books.size(); }));
+  }
+
+  SUBCASE("FailedTransactionStillPublishes") {
+    CHECK_THROWS_AS(list.transaction([&](BookList& books) {
+                      books.insert(book_1).insert(book_2);
+                      throw std::runtime_error("abandoned");
+                    }),
+                    std::runtime_error);
+    CHECK_EQ(2U, list.size());
+    CHECK_EQ(1U, list.version());
+  }
+
+  SUBCASE("ReadCachedSkipsUnchangedList") {
+    int reads = 0;
+    ConcurrentBookList::Cached<std::size_t> offset;
+    const auto find_book_2 = [&](const BookList& books) {
+      ++reads;
+      return books.find(book_2);
+    };
+
+    list.insert(book_1).insert(book_2);
+    CHECK_EQ(0U, list.read_cached(offset, find_book_2));
+    CHECK_EQ(0U, list.read_cached(offset, find_book_2));
+    CHECK_EQ(1, reads);
+
+    list.insert(book_3);
+    CHECK_EQ(1U, list.read_cached(offset, find_book_2));
+    CHECK_EQ(2, reads);
+  }
+
+  SUBCASE("ReadersSeeWholeTransactions") {
+    // Each transaction adds a pair of books, so every reader must see an even
+    // number of them, and a matched pair at the top.
+    // The readers stop after a fixed number of reads rather than when the
+    // writer is done, since a shared lock may let readers keep a writer out.
+    constexpr int pairs = 200;
+    constexpr int reads = 2000;
+    std::atomic<int> torn_reads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+      readers.emplace_back([&] {
+        ConcurrentBookList::Cached<bool> cached_ok;
+        for (int i = 0; i < reads; ++i) {
+          const auto check = [](const BookList& books) {
+            return books.size() % 2 == 0
+                && (books.size() == 0 || books.at(0).isbn() == books.at(1).isbn() + "b");
+          };
+          if (!list.read(check) || !list.read_cached(cached_ok, check) || list.size() % 2 != 0) {
+            ++torn_reads;
+          }
+        }
+      });
+    }
+
+    std::thread writer([&] {
+      for (int i = 0; i < pairs; ++i) {
+        const std::string isbn = std::to_string(i);
+        list.transaction([&](BookList& books) {
+          books.insert(Book("first", "author", isbn));
+          books.insert(Book("second", "author", isbn + "b"));
+        });
+      }
+    });
+
+    writer.join();
+    for (std::thread& reader : readers) {
+      reader.join();
+    }
+    CHECK_EQ(0, torn_reads.load());
+    CHECK_EQ(2U * pairs, list.size());
+    CHECK_EQ(static_cast<std::uint64_t>(pairs), list.version());
+  }
+}
@@ -0,0 +1,253 @@
+#include "isbn_column.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <immintrin.h>
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+namespace {
+  // Which lanes of a slot hold an ISBN's digits, the largest value each digit
+  // may have (X stands for 10, but only as the last digit of an ISBN-10) and
+  // the weight of each digit in the checksum, which must be a multiple of
+  // `modulus`.
+  struct IsbnForm {
+    alignas(16) unsigned char lanes[16];
+    alignas(16) unsigned char x_lane[16];
+    alignas(16) unsigned char limits[16];
+    alignas(16) unsigned char weights[16];
+    unsigned modulus;
+  };
+
+  constexpr unsigned char all = 0xFF;
+
+  constexpr IsbnForm isbn_10 = {
+      {all, all, all, all, all, all, all, all, all, all, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0, 0, 0, all, 0, 0, 0, 0, 0, 0},
+      {9, 9, 9, 9, 9, 9, 9, 9, 9, 10, 0, 0, 0, 0, 0, 0},
+      {10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0, 0, 0, 0, 0},
+      11};
+
+  constexpr IsbnForm isbn_13 = {
+      {all, all, all, all, all, all, all, all, all, all, all, all, all, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+      {9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0},
+      {1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 0, 0, 0},
+      10};
+
+  // Returns the offset of the first of the `count` slots from `first` on that
+  // equals `needle`, or `count` if there is none.
+  std::size_t find_slot(const unsigned char* slots, std::size_t first,
+                        std::size_t count, const unsigned char* needle) noexcept {
+    std::size_t offset = first;
+#if defined(__AVX2__)
+    // Two slots per comparison; the SSE2 loop below takes the odd one out.
+    const __m256i key_pair =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(needle)));
+    for (; offset + 2 <= count; offset += 2) {
+      const __m256i pair = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slots + offset * 16));
+      const auto equal = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(pair, key_pair)));
+      if ((equal & 0xFFFF) == 0xFFFF) {
+        return offset;
+      }
+      if ((equal >> 16) == 0xFFFF) {
+        return offset + 1;
+      }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(needle));
+    for (; offset < count; ++offset) {
+      const __m128i slot = _mm_loadu_si128(reinterpret_cast<const __m128i*>(slots + offset * 16));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(slot, key)) == 0xFFFF) {
+        return offset;
+      }
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t key = vld1q_u8(needle);
+    for (; offset < count; ++offset) {
+      const uint8x16_t equal = vceqq_u8(vld1q_u8(slots + offset * 16), key);
+      // Folding the two halves together leaves all ones only if every lane
+      // matched.
+      const uint8x8_t folded = vand_u8(vget_low_u8(equal), vget_high_u8(equal));
+      if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) == ~std::uint64_t{0}) {
+        return offset;
+      }
+    }
+#else
+    for (; offset < count; ++offset) {
+      if (std::memcmp(slots + offset * 16, needle, 16) == 0) {
+        return offset;
+      }
+    }
+#endif
+    return count;
+  }
+
+  // Returns whether the ISBN packed in `slot` has the given form and a
+  // correct check digit.
+  bool slot_has_form(const unsigned char* slot, const IsbnForm& form) noexcept {
+#if defined(__SSE2__)
+    const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(slot));
+    const __m128i lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(form.lanes));
+    const __m128i x_lane = _mm_load_si128(reinterpret_cast<const __m128i*>(form.x_lane));
+    const __m128i limits = _mm_load_si128(reinterpret_cast<const __m128i*>(form.limits));
+    const __m128i weights = _mm_load_si128(reinterpret_cast<const __m128i*>(form.weights));
+
+    // Turns the characters into digit values, with X as 10 where allowed and
+    // zero outside the ISBN, then checks each against its limit. Anything
+    // that is not a digit wraps around to a value above every limit.
+    __m128i digits = _mm_and_si128(_mm_sub_epi8(characters, _mm_set1_epi8('0')), lanes);
+    const __m128i x = _mm_and_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8('X')), x_lane);
+    digits = _mm_or_si128(_mm_andnot_si128(x, digits), _mm_and_si128(x, _mm_set1_epi8(10)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, limits), digits)) != 0xFFFF) {
+      return false;
+    }
+
+    // Widens digits and weights to 16 bits to multiply and add them in pairs,
+    // then adds the four partial sums.
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpacklo_epi8(digits, zero), _mm_unpacklo_epi8(weights, zero)),
+        _mm_madd_epi16(_mm_unpackhi_epi8(digits, zero), _mm_unpackhi_epi8(weights, zero)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4E));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xB1));
+    return static_cast<unsigned>(_mm_cvtsi128_si32(sums)) % form.modulus == 0;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t characters = vld1q_u8(slot);
+    const uint8x16_t lanes = vld1q_u8(form.lanes);
+    const uint8x16_t limits = vld1q_u8(form.limits);
+    const uint8x16_t weights = vld1q_u8(form.weights);
+
+    uint8x16_t digits = vandq_u8(vsubq_u8(characters, vdupq_n_u8('0')), lanes);
+    const uint8x16_t x = vandq_u8(vceqq_u8(characters, vdupq_n_u8('X')), vld1q_u8(form.x_lane));
+    digits = vbslq_u8(x, vdupq_n_u8(10), digits);
+    if (vminvq_u8(vceqq_u8(vminq_u8(digits, limits), digits)) != 0xFF) {
+      return false;
+    }
+
+    const uint16x8_t products = vaddq_u16(vmull_u8(vget_low_u8(digits), vget_low_u8(weights)),
+                                          vmull_u8(vget_high_u8(digits), vget_high_u8(weights)));
+    return vaddvq_u16(products) % form.modulus == 0;
+#else
+    unsigned sum = 0;
+    for (std::size_t lane = 0; lane < 16; ++lane) {
+      unsigned digit = 0;
+      if (form.x_lane[lane] != 0 && slot[lane] == 'X') {
+        digit = 10;
+      } else if (form.lanes[lane] != 0) {
+        digit = static_cast<unsigned char>(slot[lane] - '0');
+      }
+      if (digit > form.limits[lane]) {
+        return false;
+      }
+      sum += digit * form.weights[lane];
+    }
+    return sum % form.modulus == 0;
+#endif
+  }
+
+  // Returns whether the ISBN packed in `slot` is a valid ISBN-10 or ISBN-13.
+  bool slot_is_valid(const unsigned char* slot) noexcept {
+    switch (slot[15]) {
+      case 10:
+        return slot_has_form(slot, isbn_10);
+      case 13:
+        return slot_has_form(slot, isbn_13);
+      default:
+        return false;
+    }
+  }
+}
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+IsbnColumn::IsbnColumn(const BookList& books) {
+  slots_.reserve(books.size() * slot_size);
+  for (auto position = books.primary_begin(); position != books.primary_end(); ++position) {
+    push_back(position->isbn());
+  }
+}
+
+IsbnColumn::IsbnColumn(const std::vector<Book>& books) {
+  slots_.reserve(books.size() * slot_size);
+  for (const Book& book : books) {
+    push_back(book.isbn());
+  }
+}
+
+//
+// Queries
+//
+
+std::size_t IsbnColumn::size() const noexcept {
+  return slots_.size() / slot_size;
+}
+
+std::size_t IsbnColumn::find_by_isbn(std::string_view isbn) const {
+  alignas(16) unsigned char needle[slot_size];
+  pack(isbn, needle);
+
+  std::size_t offset = find_slot(slots_.data(), 0, size(), needle);
+  if (isbn.size() <= slot_chars) {
+    return offset;
+  }
+
+  // Only the prefix was compared, so check the rest of each candidate.
+  while (offset != size() && long_isbns_.at(offset) != isbn) {
+    offset = find_slot(slots_.data(), offset + 1, size(), needle);
+  }
+  return offset;
+}
+
+std::vector<std::size_t> IsbnColumn::invalid() const {
+  std::vector<std::size_t> offsets;
+  for (std::size_t offset = 0; offset != size(); ++offset) {
+    if (!slot_is_valid(slots_.data() + offset * slot_size)) {
+      offsets.push_back(offset);
+    }
+  }
+  return offsets;
+}
+
+bool IsbnColumn::valid(std::string_view isbn) noexcept {
+  if (isbn.size() != 10 && isbn.size() != 13) {
+    return false;
+  }
+  alignas(16) unsigned char slot[slot_size];
+  pack(isbn, slot);
+  return slot_is_valid(slot);
+}
+
+//
+// Packing
+//
+
+void IsbnColumn::pack(std::string_view isbn, unsigned char* slot) noexcept {
+  const std::size_t length = std::min(isbn.size(), slot_chars);
+  std::memset(slot, 0, slot_size);
+  std::memcpy(slot, isbn.data(), length);
+  slot[slot_chars] = static_cast<unsigned char>(std::min<std::size_t>(isbn.size(), 0xFF));
+}
+
+void IsbnColumn::push_back(const std::string& isbn) {
+  const std::size_t offset = size();
+  slots_.resize(slots_.size() + slot_size);
+  pack(isbn, slots_.data() + offset * slot_size);
+  if (isbn.size() > slot_chars) {
+    long_isbns_.emplace(offset, isbn);
+  }
+}
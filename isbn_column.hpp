@@ -0,0 +1,77 @@
+#ifndef _isbn_column_hpp_
+#define _isbn_column_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The IsbnColumn class packs the ISBNs of a book list into one contiguous
+// column, so a lookup by ISBN scans plain bytes instead of walking books, and
+// so a whole catalog can be checked for valid ISBNs in one pass.
+//
+// Each ISBN takes a 16 byte slot: its first 15 characters, zero padded, then
+// its length. The 10 and 13 character ISBNs of book.hpp fit a slot whole,
+// and a slot is compared in a single SIMD instruction, two at a time with
+// AVX2. Builds without SSE2, AVX2 or NEON compare the slots in scalar code.
+//
+// The column is a copy taken when it is built; it does not follow later
+// changes to the list, so build it from lists that have stopped changing,
+// such as a VersionedBookList snapshot or a freshly parsed catalog.
+class IsbnColumn {
+ public:
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // These constructors pack the ISBNs of `books` in list order.
+  explicit IsbnColumn(const BookList& books);
+  explicit IsbnColumn(const std::vector<Book>& books);
+
+  //
+  // Queries
+  //
+
+  // Returns the number of ISBNs in the column.
+  std::size_t size() const noexcept;
+
+  // Returns the offset of the first book with `isbn`, or size() if there is
+  // none.
+  std::size_t find_by_isbn(std::string_view isbn) const;
+
+  // Returns the offsets of the books whose ISBNs are not valid() ISBN-10s or
+  // ISBN-13s, in increasing order.
+  std::vector<std::size_t> invalid() const;
+
+  // Returns whether `isbn` is a 10 digit ISBN-10, whose last digit may be X,
+  // or a 13 digit ISBN-13, with a correct check digit. Hyphens and spaces are
+  // not accepted.
+  static bool valid(std::string_view isbn) noexcept;
+
+ private:
+  // The size of a slot in bytes.
+  static constexpr std::size_t slot_size = 16;
+
+  // The number of ISBN characters a slot holds; the last byte is the length.
+  static constexpr std::size_t slot_chars = slot_size - 1;
+
+  // Fills `slot` with the packed form of `isbn`.
+  static void pack(std::string_view isbn, unsigned char* slot) noexcept;
+
+  // Appends the ISBN of one book to the column.
+  void push_back(const std::string& isbn);
+
+  // The slots, slot_size bytes each, in list order.
+  std::vector<unsigned char> slots_;
+
+  // The ISBNs longer than slot_chars, by offset. Their slots hold only a
+  // prefix, so a slot match is confirmed here.
+  std::unordered_map<std::size_t, std::string> long_isbns_;
+};
+
+#endif
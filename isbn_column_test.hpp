@@ -0,0 +1,77 @@
+// Unit tests for the IsbnColumn class.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "doctest.hpp"
+#include "isbn_column.hpp"
+
+TEST_CASE("IsbnColumn") {
+  SUBCASE("FindByIsbn") {
+    const BookList list({Book("title_1", "author", "0306406152"),
+                         Book("title_2", "author", "9780306406157"),
+                         Book("title_3", "author", "9780306406157"),
+                         Book("title_4", "author", "978030640615"),
+                         Book("title_5", "author", "")});
+    const IsbnColumn column(list);
+
+    CHECK_EQ(5U, column.size());
+    CHECK_EQ(0U, column.find_by_isbn("0306406152"));
+    CHECK_EQ(1U, column.find_by_isbn("9780306406157"));
+    CHECK_EQ(3U, column.find_by_isbn("978030640615"));
+    CHECK_EQ(4U, column.find_by_isbn(""));
+    CHECK_EQ(5U, column.find_by_isbn("030640615"));
+    CHECK_EQ(5U, column.find_by_isbn("9780064430173"));
+  }
+
+  SUBCASE("FindsEveryOffset") {
+    // Enough books for the vector loops, and an odd count for their tails.
+    std::vector<Book> books;
+    for (int i = 0; i < 101; ++i) {
+      books.emplace_back("title", "author", std::to_string(1000000000 + i));
+    }
+    const IsbnColumn column(books);
+    for (std::size_t offset = 0; offset < books.size(); ++offset) {
+      CHECK_EQ(offset, column.find_by_isbn(books[offset].isbn()));
+    }
+  }
+
+  SUBCASE("LongIsbns") {
+    // These share their first 15 characters, which is all a slot holds.
+    const std::vector<Book> books({Book("title", "author", "123456789012345-A"),
+                                   Book("title", "author", "123456789012345-B"),
+                                   Book("title", "author", "123456789012345")});
+    const IsbnColumn column(books);
+    CHECK_EQ(1U, column.find_by_isbn("123456789012345-B"));
+    CHECK_EQ(0U, column.find_by_isbn("123456789012345-A"));
+    CHECK_EQ(2U, column.find_by_isbn("123456789012345"));
+    CHECK_EQ(3U, column.find_by_isbn("123456789012345-C"));
+  }
+
+  SUBCASE("Valid") {
+    CHECK(IsbnColumn::valid("0306406152"));
+    CHECK(IsbnColumn::valid("080442957X"));
+    CHECK(IsbnColumn::valid("9780306406157"));
+    CHECK(IsbnColumn::valid("9780064430173"));
+
+    CHECK_FALSE(IsbnColumn::valid("0306406153"));
+    CHECK_FALSE(IsbnColumn::valid("9780306406158"));
+    CHECK_FALSE(IsbnColumn::valid("X306406152"));
+    CHECK_FALSE(IsbnColumn::valid("978030640615X"));
+    CHECK_FALSE(IsbnColumn::valid("0-306-40615-2"));
+    CHECK_FALSE(IsbnColumn::valid("03064061/2"));
+    CHECK_FALSE(IsbnColumn::valid("030640615"));
+    CHECK_FALSE(IsbnColumn::valid(""));
+  }
+
+  SUBCASE("Invalid") {
+    const std::vector<Book> books({Book("title_1", "author", "0306406152"),
+                                   Book("title_2", "author", "isbn"),
+                                   Book("title_3", "author", "9780306406157"),
+                                   Book("title_4", "author", "9780306406158")});
+    CHECK_EQ(std::vector<std::size_t>({1, 3}), IsbnColumn(books).invalid());
+  }
+}
@@ -5,4 +5,17 @@
 #include "doctest.hpp"
 
 #include "book_test.hpp"
-#include "book_list_test.hpp"
\ No newline at end of file
+#include "book_array_test.hpp"
+#include "book_chunks_test.hpp"
+#include "book_list_test.hpp"
+#include "book_list_parser_test.hpp"
+#include "book_list_importer_test.hpp"
+#include "book_list_snapshot_test.hpp"
+#include "book_list_journal_test.hpp"
+#include "book_list_columns_test.hpp"
+#include "book_cache_test.hpp"
+#include "concurrent_book_list_test.hpp"
+#include "versioned_book_list_test.hpp"
+#include "static_book_list_test.hpp"
+#include "isbn_column_test.hpp"
+#include "string_pool_test.hpp"
\ No newline at end of file
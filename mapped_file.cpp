@@ -0,0 +1,74 @@
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+MappedFile::MappedFile(const std::string& path) {
+  const int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor == -1) {
+    throw OpenException("Cannot open " + path + ": " + std::strerror(errno));
+  }
+
+  struct stat status;
+  if (::fstat(descriptor, &status) == -1) {
+    const int error = errno;
+    ::close(descriptor);
+    throw OpenException("Cannot read the size of " + path + ": " + std::strerror(error));
+  }
+
+  // mmap rejects a zero length, and there is nothing to map anyway.
+  if (status.st_size > 0) {
+    void* data = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      ::close(descriptor);
+      throw OpenException("Cannot map " + path + ": " + std::strerror(error));
+    }
+    data_ = static_cast<const char*>(data);
+    size_ = static_cast<std::size_t>(status.st_size);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  ::close(descriptor);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+  std::swap(data_, rhs.data_);
+  std::swap(size_, rhs.size_);
+  return *this;
+}
+
+MappedFile::~MappedFile() noexcept {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+//
+// Queries
+//
+
+std::string_view MappedFile::contents() const noexcept {
+  return std::string_view(data_, size_);
+}
+
+std::size_t MappedFile::size() const noexcept {
+  return size_;
+}
@@ -0,0 +1,61 @@
+#ifndef _mapped_file_hpp_
+#define _mapped_file_hpp_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// The MappedFile class maps a whole file read-only into memory, so its
+// contents can be read as one contiguous buffer without copying them through
+// a stream. The mapping is released when the MappedFile is destroyed.
+//
+// This uses POSIX mmap; an empty file maps to an empty buffer.
+class MappedFile {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  struct OpenException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor maps the file at `path`. Throws OpenException if the
+  // file cannot be opened or mapped.
+  explicit MappedFile(const std::string& path);
+
+  // A mapping has a single owner, so it can be moved but not copied.
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& rhs) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+  // The destructor unmaps the file.
+  ~MappedFile() noexcept;
+
+  //
+  // Queries
+  //
+
+  // Returns the contents of the file. The view is valid as long as the
+  // MappedFile is.
+  std::string_view contents() const noexcept;
+
+  // Returns the size of the file in bytes.
+  std::size_t size() const noexcept;
+
+ private:
+  // The start of the mapping, or nullptr for an empty file.
+  const char* data_ = nullptr;
+
+  // The size of the mapping in bytes.
+  std::size_t size_ = 0;
+};
+
+#endif
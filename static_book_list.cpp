@@ -0,0 +1,19 @@
+#include "static_book_list.hpp"
+
+#include "book.hpp"
+
+//
+// Conversions
+//
+
+Book StaticBook::to_book() const {
+  return Book(title, author, isbn, price);
+}
+
+//
+// Relational Operators
+//
+
+bool StaticBook::matches(const Book& book) const noexcept {
+  return price == book.price() && isbn == book.isbn() && title == book.title() && author == book.author();
+}
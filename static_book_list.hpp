@@ -0,0 +1,239 @@
+#ifndef _static_book_list_hpp_
+#define _static_book_list_hpp_
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The StaticBook struct holds the attributes of a book known when the program
+// is built. Unlike Book it owns no strings and interns nothing, so it is a
+// literal type: it can be built, compared and stored in constant expressions,
+// and its views point straight at string literals.
+struct StaticBook {
+  //
+  // Attributes
+  //
+
+  std::string_view isbn;
+  std::string_view title;
+  std::string_view author;
+  double price = 0.0;
+
+  //
+  // Conversions
+  //
+
+  // Returns the book as a Book, interning its title and author.
+  Book to_book() const;
+
+  //
+  // Relational Operators
+  //
+
+  // Two books are equal when all four attributes are, as for Book.
+  constexpr bool operator==(const StaticBook& rhs) const noexcept;
+  constexpr bool operator!=(const StaticBook& rhs) const noexcept;
+
+  // Returns whether the book holds the same attributes as `book`.
+  bool matches(const Book& book) const noexcept;
+};
+
+// The StaticBookList class template is a fixed book list of N books built
+// entirely at compile time, for curated lists known when the program is
+// built. Declared constexpr at namespace scope, as in
+//
+//   constexpr auto staff_picks = make_static_book_list({
+//       {"9780321563842", "The C++ Programming Language", "Bjarne Stroustrup", 64.99},
+//       {"9780201633610", "Design Patterns", "Erich Gamma", 54.99},
+//   });
+//
+// the list is a std::array of views into string literals, placed in
+// read-only memory with the literals themselves, so startup does no work and
+// allocates nothing for it. A repeated book makes the constructor throw,
+// which in a constant expression stops the build.
+//
+// The list has BookList's query interface, with offsets from the top and
+// size() for a book not found. Call to_book_list() for a BookList to modify.
+template <std::size_t N>
+class StaticBookList {
+ public:
+  //
+  // Types and Exceptions
+  //
+
+  using const_iterator = typename std::array<StaticBook, N>::const_iterator;
+  using iterator = const_iterator;
+
+  // Thrown, or reported by the compiler in a constant expression, if a book
+  // is given twice.
+  struct DuplicateBookException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+  };
+
+  //
+  // Constructors
+  //
+
+  // This constructor constructs the list from its books, top to bottom.
+  //
+  // Books are checked against each other pairwise. That is quadratic, but the
+  // check runs once, in the compiler, for lists of a few hundred books.
+  constexpr explicit StaticBookList(const StaticBook (&books)[N]);
+
+  //
+  // Queries
+  //
+
+  // Returns the number of books in the list.
+  constexpr std::size_t size() const noexcept;
+
+  // Returns the (zero-based) offset from the top of the list for book, or
+  // size() if the book is not in the list.
+  constexpr std::size_t find(const StaticBook& book) const noexcept;
+  std::size_t find(const Book& book) const noexcept;
+
+  // Returns the book at the (zero-based) offset from the top of the list.
+  //
+  // Throws BookList::InvalidOffsetException if the offset is not less than
+  // size().
+  constexpr const StaticBook& at(std::size_t offset_from_top) const;
+
+  // Returns the book at the (zero-based) offset from the top of the list,
+  // which must be less than size().
+  constexpr const StaticBook& operator[](std::size_t offset_from_top) const noexcept;
+
+  // Iterators over the books, top to bottom.
+  constexpr const_iterator begin() const noexcept;
+  constexpr const_iterator end() const noexcept;
+  constexpr const_iterator cbegin() const noexcept;
+  constexpr const_iterator cend() const noexcept;
+
+  //
+  // Conversions
+  //
+
+  // Returns a BookList holding the same books in the same order, with room
+  // for `capacity` books, added in one batch.
+  BookList to_book_list(std::size_t capacity = BookList::unbounded_capacity) const;
+
+ private:
+  // The books, top to bottom.
+  std::array<StaticBook, N> books_{};
+};
+
+// Returns the list of `books`, top to bottom, deducing their number.
+//
+// Prefer this to deducing the class template's arguments from the
+// constructor: GCC does not place a constexpr variable declared that way in
+// read-only memory.
+template <std::size_t N>
+constexpr StaticBookList<N> make_static_book_list(const StaticBook (&books)[N]);
+
+//
+// Constexpr Member Definitions
+//
+
+constexpr bool StaticBook::operator==(const StaticBook& rhs) const noexcept {
+  return isbn == rhs.isbn && title == rhs.title && author == rhs.author && price == rhs.price;
+}
+
+constexpr bool StaticBook::operator!=(const StaticBook& rhs) const noexcept {
+  return !(*this == rhs);
+}
+
+template <std::size_t N>
+constexpr StaticBookList<N>::StaticBookList(const StaticBook (&books)[N]) {
+  for (std::size_t offset = 0; offset < N; ++offset) {
+    for (std::size_t earlier = 0; earlier < offset; ++earlier) {
+      if (books[earlier] == books[offset]) {
+        throw DuplicateBookException("StaticBookList: a book is listed twice");
+      }
+    }
+    books_[offset] = books[offset];
+  }
+}
+
+template <std::size_t N>
+constexpr std::size_t StaticBookList<N>::size() const noexcept {
+  return N;
+}
+
+template <std::size_t N>
+constexpr std::size_t StaticBookList<N>::find(const StaticBook& book) const noexcept {
+  std::size_t offset = 0;
+  while (offset < N && books_[offset] != book) {
+    ++offset;
+  }
+  return offset;
+}
+
+template <std::size_t N>
+std::size_t StaticBookList<N>::find(const Book& book) const noexcept {
+  std::size_t offset = 0;
+  while (offset < N && !books_[offset].matches(book)) {
+    ++offset;
+  }
+  return offset;
+}
+
+template <std::size_t N>
+constexpr const StaticBook& StaticBookList<N>::at(std::size_t offset_from_top) const {
+  if (offset_from_top >= N) {
+    throw BookList::InvalidOffsetException("Offset beyond end of current list size in at");
+  }
+  return books_[offset_from_top];
+}
+
+template <std::size_t N>
+constexpr const StaticBook& StaticBookList<N>::operator[](std::size_t offset_from_top) const noexcept {
+  return books_[offset_from_top];
+}
+
+template <std::size_t N>
+constexpr typename StaticBookList<N>::const_iterator StaticBookList<N>::begin() const noexcept {
+  return books_.begin();
+}
+
+template <std::size_t N>
+constexpr typename StaticBookList<N>::const_iterator StaticBookList<N>::end() const noexcept {
+  return books_.end();
+}
+
+template <std::size_t N>
+constexpr typename StaticBookList<N>::const_iterator StaticBookList<N>::cbegin() const noexcept {
+  return begin();
+}
+
+template <std::size_t N>
+constexpr typename StaticBookList<N>::const_iterator StaticBookList<N>::cend() const noexcept {
+  return end();
+}
+
+template <std::size_t N>
+constexpr StaticBookList<N> make_static_book_list(const StaticBook (&books)[N]) {
+  return StaticBookList<N>(books);
+}
+
+//
+// Template Member Definitions
+//
+
+template <std::size_t N>
+BookList StaticBookList<N>::to_book_list(std::size_t capacity) const {
+  std::vector<Book> books;
+  books.reserve(N);
+  for (const StaticBook& book : books_) {
+    books.push_back(book.to_book());
+  }
+  BookList book_list(capacity);
+  book_list.append(std::make_move_iterator(books.begin()), std::make_move_iterator(books.end()));
+  return book_list;
+}
+
+#endif
@@ -0,0 +1,69 @@
+// Unit tests for the StaticBookList class template.
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "allocation_counter.hpp"
+#include "book.hpp"
+#include "book_list.hpp"
+#include "doctest.hpp"
+#include "static_book_list.hpp"
+
+namespace {
+  constexpr auto staff_picks = make_static_book_list({
+      {"9780060254926", "Where the Wild Things Are", "Maurice Sendak", 12.99},
+      {"9780064430173", "Goodnight Moon", "Margaret Wise Brown", 8.99},
+      {"9780399226908", "The Very Hungry Caterpillar", "Eric Carle", 10.99},
+      // Another edition of the book above, at another price.
+      {"9780399226908", "The Very Hungry Caterpillar", "Eric Carle", 19.99},
+  });
+
+  // Built, checked and queried entirely by the compiler.
+  static_assert(std::is_trivially_destructible_v<decltype(staff_picks)>);
+  static_assert(staff_picks.size() == 4);
+  static_assert(staff_picks[1].title == "Goodnight Moon");
+  static_assert(staff_picks.at(3).price == 19.99);
+  static_assert(staff_picks.find(StaticBook{"9780064430173", "Goodnight Moon", "Margaret Wise Brown", 8.99}) == 1);
+  static_assert(staff_picks.find(StaticBook{"9780064430173", "Goodnight Moon", "Margaret Wise Brown", 9.99}) == 4);
+  static_assert(std::distance(staff_picks.begin(), staff_picks.end()) == 4);
+}
+
+TEST_CASE("StaticBookList") {
+  SUBCASE("Queries") {
+    const Book goodnight_moon("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 8.99);
+    CHECK_EQ(1U, staff_picks.find(goodnight_moon));
+    CHECK_EQ(4U, staff_picks.find(Book("Goodnight Moon", "Margaret Wise Brown", "9780064430173", 9.99)));
+    CHECK_EQ(goodnight_moon, staff_picks[1].to_book());
+    CHECK_THROWS_AS(staff_picks.at(4), BookList::InvalidOffsetException);
+  }
+
+  SUBCASE("NeverAllocates") {
+    const std::size_t allocations = allocation_counter::count([] {
+      std::size_t found = 0;
+      for (const StaticBook& book : staff_picks) {
+        found += staff_picks.find(book);
+      }
+      CHECK_EQ(0U + 1U + 2U + 3U, found);
+    });
+    CHECK_EQ(0U, allocations);
+  }
+
+  SUBCASE("DuplicateBook") {
+    // In a constant expression this fails to compile; at run time it throws.
+    const StaticBook books[] = {
+        {"9780064430173", "Goodnight Moon", "Margaret Wise Brown", 8.99},
+        {"9780060254926", "Where the Wild Things Are", "Maurice Sendak", 12.99},
+        {"9780064430173", "Goodnight Moon", "Margaret Wise Brown", 8.99},
+    };
+    CHECK_THROWS_AS(StaticBookList<3>{books}, StaticBookList<3>::DuplicateBookException);
+  }
+
+  SUBCASE("ToBookList") {
+    const BookList book_list = staff_picks.to_book_list();
+    CHECK_EQ(staff_picks.size(), book_list.size());
+    for (std::size_t offset = 0; offset < staff_picks.size(); ++offset) {
+      CHECK_EQ(staff_picks[offset].to_book(), book_list.at(offset));
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#include "string_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+  // The id the next pool constructed takes. Zero is never used, so a thread
+  // that has remembered nothing yet matches no pool.
+  std::atomic<std::uint64_t> next_pool_id{1};
+
+  // The strings a thread has interned recently, and the pool they came from.
+  struct ThreadCache {
+    std::uint64_t pool_id = 0;
+    std::unordered_map<std::string_view, const std::string*> strings;
+  };
+}
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+StringPool::StringPool() : id_(next_pool_id++) {
+  intern({});
+}
+
+StringPool::~StringPool() noexcept = default;
+
+StringPool& StringPool::shared() {
+  // Constructed on first use, so books created during static initialization
+  // still find it ready.
+  static StringPool pool;
+  return pool;
+}
+
+//
+// Queries
+//
+
+std::size_t StringPool::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return strings_.size();
+}
+
+//
+// Mutators
+//
+
+const std::string& StringPool::intern(std::string_view text) {
+  // A thread remembers the strings of one pool at a time, which is all but
+  // always StringPool::shared(). The remembered strings were handed to this
+  // thread under the lock, so reading them needs no lock of its own.
+  thread_local ThreadCache cache;
+  if (cache.pool_id != id_) {
+    cache.strings.clear();
+    cache.pool_id = id_;
+  }
+  auto remembered = cache.strings.find(text);
+  if (remembered != cache.strings.end()) {
+    return *remembered->second;
+  }
+
+  const std::string* interned;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = index_.find(text);
+    if (found != index_.end()) {
+      interned = found->second;
+    } else {
+      // The key views the pooled copy itself, which never moves, rather than
+      // `text`, which belongs to the caller.
+      const std::string& added = strings_.emplace_back(text);
+      index_.emplace(added, &added);
+      interned = &added;
+    }
+  }
+
+  if (cache.strings.size() >= thread_cache_limit) {
+    cache.strings.clear();
+  }
+  cache.strings.emplace(*interned, interned);
+  return *interned;
+}
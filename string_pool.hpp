@@ -0,0 +1,83 @@
+#ifndef _string_pool_hpp_
+#define _string_pool_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// The StringPool class keeps a single copy of each distinct string it is
+// given, so objects that repeat the same text, such as the author of many
+// books, can share one copy instead of each holding their own.
+//
+// Interned strings live as long as the pool and never move, so references to
+// them stay valid and two interned strings are equal exactly when they are
+// the same object. The pool never forgets a string, so it grows with the
+// number of distinct strings interned over its life rather than with the
+// number of objects holding them: reloading a catalog adds nothing, but a
+// process that keeps meeting new titles keeps growing.
+//
+// Each thread remembers the strings it has interned recently, so text it has
+// seen before is found without taking the lock that guards the pool, and
+// threads building books with the same authors do not queue on it.
+class StringPool {
+ public:
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor constructs a pool holding only the empty string.
+  StringPool();
+
+  // Pools hand out references to their strings, so they cannot be copied or
+  // moved.
+  StringPool(const StringPool& other) = delete;
+  StringPool& operator=(const StringPool& rhs) = delete;
+
+  // The destructor.
+  ~StringPool() noexcept;
+
+  // Returns the pool shared by the whole program.
+  static StringPool& shared();
+
+  //
+  // Queries
+  //
+
+  // Returns the number of distinct strings in the pool.
+  std::size_t size() const;
+
+  //
+  // Mutators
+  //
+
+  // Returns the pool's copy of `text`, adding one if the pool has none yet.
+  // Safe to call from several threads at once. Takes the lock only for text
+  // this thread has not interned among its last thread_cache_limit strings.
+  const std::string& intern(std::string_view text);
+
+  // The most strings each thread remembers before it forgets them all and
+  // starts over.
+  static constexpr std::size_t thread_cache_limit = 4096;
+
+ private:
+  // Tells this pool apart from every other pool, including one constructed
+  // later at the same address, so a thread never takes a string remembered
+  // from one pool for a string of another.
+  const std::uint64_t id_;
+
+  // Guards strings_ and index_.
+  mutable std::mutex mutex_;
+
+  // The interned strings. A deque never relocates its elements as it grows.
+  std::deque<std::string> strings_;
+
+  // Maps a view of every string in strings_ to that string, for looking text
+  // up without building a std::string first.
+  std::unordered_map<std::string_view, const std::string*> index_;
+};
+
+#endif
@@ -0,0 +1,74 @@
+// Unit tests for the StringPool class.
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "doctest.hpp"
+#include "string_pool.hpp"
+
+TEST_CASE("StringPool") {
+  StringPool pool;
+
+  SUBCASE("StartsWithEmptyString") {
+    CHECK_EQ(1U, pool.size());
+    CHECK_EQ("", pool.intern(""));
+    CHECK_EQ(1U, pool.size());
+  }
+
+  SUBCASE("InternsEachStringOnce") {
+    const std::string& first = pool.intern("Margaret Wise Brown");
+    const std::string& second = pool.intern(std::string("Margaret Wise ") + "Brown");
+    CHECK_EQ(&first, &second);
+    CHECK_EQ("Margaret Wise Brown", first);
+    CHECK_EQ(2U, pool.size());
+  }
+
+  SUBCASE("KeepsReferencesStable") {
+    const std::string& first = pool.intern("first");
+    for (int i = 0; i < 1000; ++i) {
+      pool.intern("string-" + std::to_string(i));
+    }
+    CHECK_EQ(&first, &pool.intern("first"));
+    CHECK_EQ("first", first);
+    CHECK_EQ(1002U, pool.size());
+  }
+
+  SUBCASE("SameStringOnEveryThread") {
+    const std::string& here = pool.intern("shared");
+    const std::string* there = nullptr;
+    std::thread([&] { there = &pool.intern("shared"); }).join();
+    CHECK_EQ(&here, there);
+    CHECK_EQ(2U, pool.size());
+  }
+
+  SUBCASE("ThreadsKeepPoolsApart") {
+    // The same thread alternates between pools, and between a pool and one
+    // constructed in its place, without mixing up their strings.
+    const std::string& first = pool.intern("text");
+    StringPool other;
+    const std::string& other_first = other.intern("text");
+    CHECK_NE(&first, &other_first);
+    CHECK_EQ(&first, &pool.intern("text"));
+    CHECK_EQ(&other_first, &other.intern("text"));
+    CHECK_EQ(2U, other.size());
+  }
+
+  SUBCASE("ForgetsNothingPastTheThreadLimit") {
+    const std::string& first = pool.intern("first");
+    for (std::size_t i = 0; i <= StringPool::thread_cache_limit; ++i) {
+      pool.intern("string-" + std::to_string(i));
+    }
+    CHECK_EQ(&first, &pool.intern("first"));
+    CHECK_EQ(StringPool::thread_cache_limit + 3, pool.size());
+  }
+
+  SUBCASE("Substrings") {
+    const std::string_view text = "Goodnight Moon";
+    const std::string& goodnight = pool.intern(text.substr(0, 9));
+    const std::string& moon = pool.intern(text.substr(10));
+    CHECK_EQ("Goodnight", goodnight);
+    CHECK_EQ("Moon", moon);
+  }
+}
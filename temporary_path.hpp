@@ -0,0 +1,55 @@
+#ifndef _temporary_path_hpp_
+#define _temporary_path_hpp_
+
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <unistd.h>
+
+// The TemporaryPath class names a file in the system's temporary directory
+// for a test to write, and removes whatever is there when it goes away.
+//
+// Each name carries the process ID, a count of the names this process has
+// made and a random number, so test binaries running at once, on one machine
+// or on CI shards sharing a directory, never write each other's files.
+class TemporaryPath {
+ public:
+  // This constructor names a file starting with `stem`, such as
+  // "book_list_parser_test", and ending with `extension`, such as ".txt".
+  explicit TemporaryPath(std::string_view stem, std::string_view extension = {}) {
+    static std::atomic<unsigned> made{0};
+    std::string name(stem);
+    name += '.' + std::to_string(::getpid());
+    name += '.' + std::to_string(made++);
+    name += '.' + std::to_string(std::random_device()());
+    name += extension;
+    path_ = (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  TemporaryPath(const TemporaryPath& other) = delete;
+  TemporaryPath& operator=(const TemporaryPath& rhs) = delete;
+
+  // Removes the file, or the directory and everything in it, if there is one.
+  ~TemporaryPath() {
+    std::error_code ignored;
+    std::filesystem::remove_all(path_, ignored);
+  }
+
+  // Returns the path.
+  const std::string& string() const noexcept {
+    return path_;
+  }
+
+  operator const std::string&() const noexcept {
+    return path_;
+  }
+
+ private:
+  std::string path_;
+};
+
+#endif
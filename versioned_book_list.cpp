@@ -0,0 +1,92 @@
+#include "versioned_book_list.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+//
+// Constructors, Assignments, and Destructor
+//
+
+VersionedBookList::VersionedBookList(BookList books)
+    : current_(new Snapshot(std::make_shared<const BookList>(std::move(books)))) {}
+
+// No reader can be taking a snapshot while the list is destroyed, so the
+// current version is released at once; snapshots of it keep it alive.
+VersionedBookList::~VersionedBookList() noexcept {
+  delete current_.load();
+}
+
+//
+// Queries
+//
+
+VersionedBookList::Snapshot VersionedBookList::snapshot() const {
+  // Being counted before loading current_ keeps the Snapshot object it points
+  // to alive until the copy is made; see publish().
+  std::atomic<std::size_t>& readers = readers_[reader_epoch_.load()];
+  readers.fetch_add(1);
+  Snapshot current = *current_.load();
+  readers.fetch_sub(1);
+  return current;
+}
+
+std::uint64_t VersionedBookList::version() const noexcept {
+  return version_.load(std::memory_order_acquire);
+}
+
+//
+// Mutators
+//
+
+VersionedBookList& VersionedBookList::insert(const Book& book, BookList::Position position) {
+  update([&](BookList& books) { books.insert(book, position); });
+  return *this;
+}
+
+VersionedBookList& VersionedBookList::insert(const Book& book, std::size_t offset_from_top) {
+  update([&](BookList& books) { books.insert(book, offset_from_top); });
+  return *this;
+}
+
+VersionedBookList& VersionedBookList::remove(const Book& book) {
+  update([&](BookList& books) { books.remove(book); });
+  return *this;
+}
+
+VersionedBookList& VersionedBookList::remove(std::size_t offset_from_top) {
+  update([&](BookList& books) { books.remove(offset_from_top); });
+  return *this;
+}
+
+VersionedBookList& VersionedBookList::move_to_top(const Book& book) {
+  update([&](BookList& books) { books.move_to_top(book); });
+  return *this;
+}
+
+void VersionedBookList::publish(Snapshot next) {
+  const Snapshot* previous = current_.exchange(new Snapshot(std::move(next)));
+  version_.fetch_add(1, std::memory_order_release);
+
+  // Any reader that might be copying `previous` counted itself, in one of the
+  // two counters, before the exchange. Steering new readers away from each
+  // counter in turn and waiting for it to drain waits out all of them, while
+  // readers that arrive meanwhile load the new version and cannot hold the
+  // wait up for long. Readers only stay counted while copying a shared_ptr.
+  for (int counter = 0; counter < 2; ++counter) {
+    const unsigned drained = reader_epoch_.fetch_xor(1);
+    while (readers_[drained].load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  // The previous version is released here, and freed unless a reader still
+  // holds a snapshot of it.
+  delete previous;
+}
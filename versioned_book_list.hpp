@@ -0,0 +1,139 @@
+#ifndef _versioned_book_list_hpp_
+#define _versioned_book_list_hpp_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "book.hpp"
+#include "book_list.hpp"
+
+// The VersionedBookList class shares a book list between threads by
+// read-copy-update: it publishes immutable versions of the list through an
+// atomically swapped pointer.
+//
+// A reader takes a snapshot, a pointer to the current version, and can then
+// find, walk and compare it for as long as it likes. No writer ever changes
+// or frees a version a reader holds, so long scans neither block writers nor
+// are blocked by them. Taking a snapshot takes no lock and never loops: it
+// is a fixed handful of atomic operations (see snapshot()).
+//
+// A writer copies the current version, changes the copy and publishes it.
+// The copy is a deep one: BookList's copy constructor copies every book of
+// every stored container, each vector and array element, each forward_list
+// and list node, and each hash index node. Only titles and authors are
+// shared, through the StringPool. So every write costs time and allocations
+// proportional to the size of the list, however small the change; batch
+// writes with update().
+//
+// Versions are reclaimed by reference counting: each is freed when the list
+// and the last snapshot of it let it go.
+class VersionedBookList {
+ public:
+  //
+  // Types
+  //
+
+  // An immutable version of the book list.
+  using Snapshot = std::shared_ptr<const BookList>;
+
+  //
+  // Constructors, Assignments, and Destructor
+  //
+
+  // This constructor publishes `books` as the first version, numbered zero.
+  explicit VersionedBookList(BookList books = BookList(BookList::unbounded_capacity));
+
+  // The list is shared by reference between threads, so it cannot be copied
+  // or moved; share snapshots instead.
+  VersionedBookList(const VersionedBookList& other) = delete;
+  VersionedBookList& operator=(const VersionedBookList& rhs) = delete;
+
+  // The destructor. Snapshots outlive it.
+  ~VersionedBookList() noexcept;
+
+  //
+  // Queries
+  //
+
+  // Returns the current version of the book list. Never waits, for a writer
+  // or for anything else: the reader counts itself in, copies the current
+  // shared_ptr and counts itself out, three atomic read-modify-writes and no
+  // lock or loop. Every reader updates the same counters and the same
+  // reference count, though, so many threads taking snapshots at once
+  // contend for those cache lines.
+  Snapshot snapshot() const;
+
+  // Returns the number of versions published since the first one.
+  std::uint64_t version() const noexcept;
+
+  //
+  // Mutators
+  //
+
+  // Calls `writer` with a copy of the current version, publishes the copy as
+  // the next version and returns what `writer` returns. Writers take turns,
+  // but readers never wait for them.
+  //
+  // If `writer` throws, the copy is discarded and the current version stays
+  // as it was.
+  template <typename Writer>
+  auto update(Writer&& writer);
+
+  // These publish a version changed as the BookList methods of the same name
+  // change it.
+  VersionedBookList& insert(const Book& book, BookList::Position position = BookList::Position::TOP);
+  VersionedBookList& insert(const Book& book, std::size_t offset_from_top);
+  VersionedBookList& remove(const Book& book);
+  VersionedBookList& remove(std::size_t offset_from_top);
+  VersionedBookList& move_to_top(const Book& book);
+
+ private:
+  // Makes `next` the current version, then waits until no reader can still
+  // be copying the one it replaced, and frees that.
+  void publish(Snapshot next);
+
+  // Serializes writers; readers never take it.
+  std::mutex writer_mutex_;
+
+  // The current version. It is replaced with a fresh Snapshot object rather
+  // than assigned, since libstdc++ guards the atomic shared_ptr operations,
+  // std::atomic<std::shared_ptr> included, with locks a reader could wait on.
+  std::atomic<const Snapshot*> current_;
+
+  // The readers copying *current_ right now, split in two so a writer can
+  // steer new readers to one counter while it waits for the other to drain.
+  // reader_epoch_ says which counter new readers use.
+  mutable std::array<std::atomic<std::size_t>, 2> readers_{};
+  std::atomic<unsigned> reader_epoch_{0};
+
+  std::atomic<std::uint64_t> version_{0};
+};
+
+//
+// Template Member Definitions
+//
+
+template <typename Writer>
+auto VersionedBookList::update(Writer&& writer) {
+  std::lock_guard lock(writer_mutex_);
+
+  // Only writers replace current_, and they hold the mutex, so the version it
+  // points to stays alive while it is copied.
+  auto next = std::make_shared<BookList>(**current_.load());
+  if constexpr (std::is_void_v<decltype(std::forward<Writer>(writer)(*next))>) {
+    std::forward<Writer>(writer)(*next);
+    publish(std::move(next));
+  } else {
+    auto result = std::forward<Writer>(writer)(*next);
+    publish(std::move(next));
+    return result;
+  }
+}
+
+#endif
@@ -0,0 +1,100 @@
+// Unit tests for the VersionedBookList class.
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "book.hpp"
+#include "book_list.hpp"
+#include "doctest.hpp"
+#include "versioned_book_list.hpp"
+
+TEST_CASE("VersionedBookList") {
+  const Book book_1("title_1", "author", "isbn_1"),
+      book_2("title_2", "author", "isbn_2"),
+      book_3("title_3", "author", "isbn_3");
+
+  VersionedBookList list(BookList({book_1, book_2}));
+
+  SUBCASE("SnapshotsAreImmutable") {
+    const VersionedBookList::Snapshot before = list.snapshot();
+    list.insert(book_3).move_to_top(book_2).remove(book_1);
+
+    CHECK_EQ(BookList({book_1, book_2}), *before);
+    CHECK_EQ(BookList({book_2, book_3}), *list.snapshot());
+    CHECK_EQ(3U, list.version());
+    CHECK_NE(0, before->compare(*list.snapshot()));
+  }
+
+  SUBCASE("UpdatePublishesOneVersion") {
+    const std::size_t found = list.update([&](BookList& books) {
+      books.insert(book_3, BookList::Position::BOTTOM).remove(std::size_t{0});
+      return books.find(book_3);
+    });
+    CHECK_EQ(1U, found);
+    CHECK_EQ(1U, list.version());
+    CHECK_EQ(BookList({book_2, book_3}), *list.snapshot());
+  }
+
+  SUBCASE("FailedUpdatePublishesNothing") {
+    const VersionedBookList::Snapshot before = list.snapshot();
+    CHECK_THROWS_AS(list.update([&](BookList& books) {
+                      books.insert(book_3);
+                      throw std::runtime_error("abandoned");
+                    }),
+                    std::runtime_error);
+    CHECK_EQ(0U, list.version());
+    CHECK_EQ(before, list.snapshot());
+  }
+
+  SUBCASE("ReclaimsReleasedVersions") {
+    VersionedBookList::Snapshot held = list.snapshot();
+    const std::weak_ptr<const BookList> first = held;
+    list.insert(book_3);
+    const std::weak_ptr<const BookList> second = list.snapshot();
+    list.remove(book_3);
+
+    CHECK_FALSE(first.expired());
+    CHECK(second.expired());
+    held.reset();
+    CHECK(first.expired());
+  }
+
+  SUBCASE("ReadersScanWhileWritersPublish") {
+    // Each version holds the books 0 to n-1 for some n, so a reader must never
+    // see a gap, however the scan interleaves with the writers.
+    VersionedBookList numbered;
+    constexpr int books = 100;
+    std::atomic<int> bad_scans{0};
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 3; ++r) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < 300; ++i) {
+          const VersionedBookList::Snapshot snapshot = numbered.snapshot();
+          for (std::size_t offset = 0; offset < snapshot->size(); ++offset) {
+            if (snapshot->at(offset).isbn() != std::to_string(offset)) {
+              ++bad_scans;
+            }
+          }
+        }
+      });
+    }
+    threads.emplace_back([&] {
+      for (int i = 0; i < books; ++i) {
+        numbered.insert(Book("title", "author", std::to_string(i)), BookList::Position::BOTTOM);
+      }
+    });
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    CHECK_EQ(0, bad_scans.load());
+    CHECK_EQ(static_cast<std::size_t>(books), numbered.snapshot()->size());
+    CHECK_EQ(static_cast<std::uint64_t>(books), numbered.version());
+  }
+}